@@ -15,10 +15,10 @@ extern "C" {
 #include "WProgram.h"
 #endif
 #include "../digitalWriteFast/digitalWriteFast.h"
+#include "../SPIBus/SPIBus.h"
 #include "ADS7846.h"
 #include "../MI0283QT2/MI0283QT2.h"
 
-#define MIN_PRESSURE    (5) //minimum pressure
 #define LCD_WIDTH       (320)
 #define LCD_HEIGHT      (240)
 
@@ -37,62 +37,31 @@ extern "C" {
 // Set 2,5V reference on. Only useful when using readChannel(), otherwise take CMD_PWD!
 #define POWER_MODE CMD_ALWAYSON
 
-//#define SOFTWARE_SPI
-
-#if (defined(__AVR_ATmega1280__) || \
-     defined(__AVR_ATmega1281__) || \
-     defined(__AVR_ATmega2560__) || \
-     defined(__AVR_ATmega2561__))      //--- Arduino Mega ---
-//# define BUSY_PIN       (5)
-//# define IRQ_PIN        (3)
-# define CS_PIN         (6)
-# if defined(SOFTWARE_SPI)
-#  define MOSI_PIN      (11)
-#  define MISO_PIN      (12)
-#  define CLK_PIN       (13)
-# else
-#  define MOSI_PIN      (51)
-#  define MISO_PIN      (50)
-#  define CLK_PIN       (52)
-# endif
-
-#elif (defined(__AVR_ATmega644__) || \
-       defined(__AVR_ATmega644P__))    //--- Arduino 644 ---
-//# define BUSY_PIN       (15)
-//# define IRQ_PIN        (11)
-# define CS_PIN         (14)
-# define MOSI_PIN       (5)
-# define MISO_PIN       (6)
-# define CLK_PIN        (7)
-
-#else                                  //--- Arduino Uno ---
-//# define BUSY_PIN       (5)
-//# define IRQ_PIN        (3)
-# define CS_PIN         (6)
-# define MOSI_PIN       (11)
-# define MISO_PIN       (12)
-# define CLK_PIN        (13)
+#include "../SPIBus/pins.h"
 
-#endif
-
-#define CS_DISABLE()    digitalWriteFast(CS_PIN, HIGH)
-#define CS_ENABLE()     digitalWriteFast(CS_PIN, LOW)
-
-#define MOSI_HIGH()     digitalWriteFast(MOSI_PIN, HIGH)
-#define MOSI_LOW()      digitalWriteFast(MOSI_PIN, LOW)
+#define CS_DISABLE()    digitalWriteFast(TP_CS_PIN, HIGH)
+#define CS_ENABLE()     digitalWriteFast(TP_CS_PIN, LOW)
 
-#define MISO_READ()     digitalReadFast(MISO_PIN)
+//#define BUSY_READ()     digitalReadFast(TP_BUSY_PIN)
 
-#define CLK_HIGH()      digitalWriteFast(CLK_PIN, HIGH)
-#define CLK_LOW()       digitalWriteFast(CLK_PIN, LOW)
-
-//#define BUSY_READ()     digitalReadFast(BUSY_PIN)
-
-//#define IRQ_READ()      digitalReadFast(IRQ_PIN)
+//#define IRQ_READ()      digitalReadFast(TP_IRQ_PIN)
 
 //-------------------- Constructor --------------------
 
 ADS7846::ADS7846(void) {
+	pressure = 0;
+	pen_down = 0;
+	p_last = 0;
+	p_idle = 0;
+	p_noise = 0;
+	rd_time = 0;
+	setRate(TP_RATE_ACTIVE, TP_RATE_IDLE);
+	sample.pen = TP_PEN_NONE;
+#if defined(TP_RECORD)
+	rec_out = 0;
+	rep_pos = 0;
+#endif
+
 	return;
 }
 
@@ -100,41 +69,19 @@ ADS7846::ADS7846(void) {
 
 void ADS7846::init(void) {
 	//init pins
-	pinMode(CS_PIN, OUTPUT);
+	pinMode(TP_CS_PIN, OUTPUT);
 	CS_DISABLE();
-	pinMode(CLK_PIN, OUTPUT);
-	pinMode(MOSI_PIN, OUTPUT);
-	pinMode(MISO_PIN, INPUT);
-	digitalWriteFast(MISO_PIN, HIGH);
-	//pull-up
-#ifdef IRQ_PIN
-	pinMode(IRQ_PIN, INPUT);
-	digitalWriteFast(IRQ_PIN, HIGH); //pull-up
+#ifdef TP_IRQ_PIN
+	pinMode(TP_IRQ_PIN, INPUT);
+	digitalWriteFast(TP_IRQ_PIN, HIGH); //pull-up
 #endif
-#ifdef BUSY_PIN
-	pinMode(BUSY_PIN, INPUT);
-	digitalWriteFast(BUSY_PIN, HIGH); //pull-up
+#ifdef TP_BUSY_PIN
+	pinMode(TP_BUSY_PIN, INPUT);
+	digitalWriteFast(TP_BUSY_PIN, HIGH); //pull-up
 #endif
 
-#if !defined(SOFTWARE_SPI)
-	//SS has to be output or input with pull-up
-# if (defined(__AVR_ATmega1280__) || \
-      defined(__AVR_ATmega1281__) || \
-      defined(__AVR_ATmega2560__) || \
-      defined(__AVR_ATmega2561__))     //--- Arduino Mega ---
-#  define SS_PORTBIT (0) //PB0
-# elif (defined(__AVR_ATmega644__) || \
-        defined(__AVR_ATmega644P__))   //--- Arduino 644 ---
-#  define SS_PORTBIT (4) //PB4
-# else                                 //--- Arduino Uno ---
-#  define SS_PORTBIT (2) //PB2
-# endif
-	if (!(DDRB & (1 << SS_PORTBIT))) //SS is input
-	{
-		PORTB |= (1 << SS_PORTBIT); //pull-up on
-	}
-
-#endif
+	SPIBus::begin();
+	SPIBus::setClock(SPI_DEVICE_TP, 8); //clk=Fcpu/8
 
 	//set vars
 	tp_matrix.div = 0;
@@ -145,6 +92,7 @@ void ADS7846::init(void) {
 	lcd.x = 0;
 	lcd.y = 0;
 	pressure = 0;
+	rd_time = millis() - 0x8000; //first service() reads
 	setOrientation(0);
 
 	return;
@@ -165,6 +113,7 @@ void ADS7846::setOrientation(uint16_t o) {
 		lcd_orientation = 270;
 		break;
 	}
+	calc_transform();
 
 	return;
 }
@@ -189,6 +138,7 @@ uint8_t ADS7846::setCalibration(CAL_POINT *lcd, CAL_POINT *tp) {
 
 	tp_matrix.f = (tp[2].x * lcd[1].y - tp[1].x * lcd[2].y) * tp[0].y
 			+ (tp[0].x * lcd[2].y - tp[2].x * lcd[0].y) * tp[1].y + (tp[1].x * lcd[0].y - tp[0].x * lcd[1].y) * tp[2].y;
+	calc_transform();
 
 	return 1;
 }
@@ -209,6 +159,7 @@ uint8_t ADS7846::readCalibration(uint16_t eeprom_addr) {
 	c = eeprom_read_byte((uint8_t*) eeprom_addr++);
 	if (c == 0x55) {
 		eeprom_read_block((void*) &tp_matrix, (void*) eeprom_addr, sizeof(CAL_MATRIX));
+		calc_transform();
 		return 1;
 	}
 
@@ -230,23 +181,23 @@ uint8_t ADS7846::doCalibration(MI0283QT2 *lcd, uint16_t eeprom_addr, uint8_t che
 	lcd->clear(COLOR_WHITE);
 	lcd->drawTextPGM((lcd->getWidth() / 2) - 50, (lcd->getHeight() / 2) - 10, PSTR("Calibration"), 1, COLOR_BLACK,
 			COLOR_WHITE);
-	while (getPressure() > MIN_PRESSURE) {
+	while (getPressure() != 0) {
 		service();
 	};
 
 	//show calibration points
 	for (i = 0; i < 3;) {
 		//draw points
-		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 2, RGB( 0, 0, 0));
-		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 5, RGB( 0, 0, 0));
-		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 10, RGB(255, 0, 0));
+		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 2, COLOR_BLACK);
+		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 5, COLOR_BLACK);
+		lcd->drawCircle(lcd_points[i].x, lcd_points[i].y, 10, COLOR_RED);
 
 		//run service routine
 		service();
 
 		//press dectected? -> save point
-		if (getPressure() > MIN_PRESSURE) {
-			lcd->fillCircle(lcd_points[i].x, lcd_points[i].y, 2, RGB(255,0,0));
+		if (getPressure() != 0) {
+			lcd->fillCircle(lcd_points[i].x, lcd_points[i].y, 2, COLOR_RED);
 			tp_points[i].x = getXraw();
 			tp_points[i].y = getYraw();
 			i++;
@@ -266,43 +217,49 @@ uint8_t ADS7846::doCalibration(MI0283QT2 *lcd, uint16_t eeprom_addr, uint8_t che
 	writeCalibration(eeprom_addr);
 
 	//wait for touch release
-	while (getPressure() > MIN_PRESSURE) {
+	while (getPressure() != 0) {
 		service();
 	};
 
 	return 1;
 }
 
+//screen pos in the current orientation, 2 multiply-adds per axis
 void ADS7846::calibrate(void) {
+	uint16_t w, h;
 	long x, y;
 
+	if ((tp.x == tp_last.x) && (tp.y == tp_last.y)) {
+		return;
+	}
+	tp_last.x = tp.x;
+	tp_last.y = tp.y;
+
+	if ((lcd_orientation == 0) || (lcd_orientation == 180)) {
+		w = LCD_WIDTH;
+		h = LCD_HEIGHT;
+	} else {
+		w = LCD_HEIGHT;
+		h = LCD_WIDTH;
+	}
+
 	//calc x pos
-	if (tp.x != tp_last.x) {
-		tp_last.x = tp.x;
-		x = tp.x;
-		y = tp.y;
-		x = ((tp_matrix.a * x) + (tp_matrix.b * y) + tp_matrix.c) / tp_matrix.div;
-		if (x < 0) {
-			x = 0;
-		} else if (x >= LCD_WIDTH) {
-			x = LCD_WIDTH - 1;
-		}
-		lcd.x = x;
+	x = ((tp_x[0] * tp.x) + (tp_x[1] * tp.y) + tp_x[2]) >> 16;
+	if (x < 0) {
+		x = 0;
+	} else if (x >= w) {
+		x = w - 1;
 	}
+	lcd.x = x;
 
 	//calc y pos
-	if (tp.y != tp_last.y) {
-		tp_last.y = tp.y;
-		x = tp.x;
-		y = tp.y;
-		y = ((tp_matrix.d * x) + (tp_matrix.e * y) + tp_matrix.f) / tp_matrix.div;
-		if (y < 0) {
-			y = 0;
-		} else if (y >= LCD_HEIGHT) {
-			y = LCD_HEIGHT - 1;
-		}
-		lcd.y = y;
+	y = ((tp_y[0] * tp.x) + (tp_y[1] * tp.y) + tp_y[2]) >> 16;
+	if (y < 0) {
+		y = 0;
+	} else if (y >= h) {
+		y = h - 1;
 	}
+	lcd.y = y;
 
 	return;
 }
@@ -310,37 +267,13 @@ void ADS7846::calibrate(void) {
 uint16_t ADS7846::getX(void) {
 	calibrate();
 
-	//set orientation
-	switch (lcd_orientation) {
-	case 0:
-		return lcd.x;
-	case 90:
-		return lcd.y;
-	case 180:
-		return LCD_WIDTH - lcd.x;
-	case 270:
-		return LCD_HEIGHT - lcd.y;
-	}
-
-	return 0;
+	return lcd.x;
 }
 
 uint16_t ADS7846::getY(void) {
 	calibrate();
 
-	//set orientation
-	switch (lcd_orientation) {
-	case 0:
-		return lcd.y;
-	case 90:
-		return LCD_WIDTH - lcd.x;
-	case 180:
-		return LCD_HEIGHT - lcd.y;
-	case 270:
-		return lcd.x;
-	}
-
-	return 0;
+	return lcd.y;
 }
 
 uint16_t ADS7846::getXraw(void) {
@@ -356,11 +289,64 @@ uint8_t ADS7846::getPressure(void) {
 }
 
 void ADS7846::service(void) {
+#if defined(TP_RECORD)
+	uint16_t x = tp.x, y = tp.y;
+	uint8_t p = pressure;
+
+	if (rep_pos != 0) {
+		replay_samples();
+	} else if (rd_due()) {
+		rd_data();
+		if (rec_out != 0) {
+			record_sample(x, y, p);
+		}
+	} else {
+		return;
+	}
+#else
+	if (!rd_due()) {
+		return;
+	}
 	rd_data();
+#endif
+	update_sample();
 
 	return;
 }
 
+void ADS7846::setRate(uint8_t active, uint8_t idle) {
+	rd_period[0] = (idle != 0) ? (1000 / idle) : 0;
+	rd_period[1] = (active != 0) ? (1000 / active) : 0;
+
+	return;
+}
+
+uint8_t ADS7846::getThreshold(void) {
+	uint16_t t = (p_noise >> 3) + TP_PRESSURE_MARGIN;
+
+	if (t < TP_PRESSURE_MIN) {
+		t = TP_PRESSURE_MIN;
+	} else if (t > TP_PRESSURE_MAX) {
+		t = TP_PRESSURE_MAX;
+	}
+
+	return (uint8_t) t;
+}
+
+const TP_SAMPLE *ADS7846::getSample(void) {
+	return &sample;
+}
+
+uint8_t ADS7846::readPressure(void) {
+	uint8_t p;
+
+	SPIBus::beginTransaction(SPI_DEVICE_TP);
+	p = rd_pressure();
+	SPIBus::endTransaction();
+
+	return p;
+}
+
 // read individual A/D channels like temperature or Vcc
 uint16_t ADS7846::readChannel(uint8_t channel, uint8_t numberOfReadingsToIntegrate) {
 	channel <<= 4;
@@ -369,14 +355,7 @@ uint16_t ADS7846::readChannel(uint8_t channel, uint8_t numberOfReadingsToIntegra
 	uint16_t tRetValue = 0;
 	uint8_t low, high, i;
 
-//SPI speed-down
-#if !defined(SOFTWARE_SPI)
-	uint8_t spcr, spsr;
-	spcr = SPCR;
-	SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
-	spsr = SPSR;
-	SPSR = (1 << SPI2X); //clk*2 -> clk=Fcpu/8
-#endif
+	SPIBus::beginTransaction(SPI_DEVICE_TP);
 
 //read channel
 	CS_ENABLE();
@@ -387,128 +366,385 @@ uint16_t ADS7846::readChannel(uint8_t channel, uint8_t numberOfReadingsToIntegra
 		tRetValue += (high << 4) | (low >> 4); //12bit: ((a<<4)|(b>>4)) //10bit: ((a<<2)|(b>>6))
 	}
 	CS_DISABLE();
-//restore SPI settings
-#if !defined(SOFTWARE_SPI)
-	SPCR = spcr;
-	SPSR = spsr;
-#endif
+	SPIBus::endTransaction();
 
 	return tRetValue / numberOfReadingsToIntegrate;
 }
 
-//-------------------- Private --------------------
+#if defined(TP_RECORD)
+void ADS7846::record(Print *out) {
+	long *m = &tp_matrix.a;
+	uint8_t i, buf[4];
 
-void ADS7846::rd_data(void) {
-	uint8_t a, b, i;
-	uint16_t x, y;
+	rec_out = out;
+	if (out == 0) {
+		return;
+	}
+	out->write('T');
+	out->write('P');
+	for (i = 0; i < 7; i++, m++) { //a b c d e f div
+		buf[0] = *m;
+		buf[1] = *m >> 8;
+		buf[2] = *m >> 16;
+		buf[3] = *m >> 24;
+		out->write(buf, 4);
+	}
+	rec_time = millis();
+	record_sample(0xFFFF, 0xFFFF, 0xFF); //current state
+
+	return;
+}
+
+void ADS7846::replay(const uint8_t *stream, uint16_t length, uint8_t pgm) {
+	long *m = &tp_matrix.a;
+	uint32_t v;
+	uint8_t i;
+
+	rep_pos = stream;
+	rep_end = stream + length;
+	rep_pgm = pgm;
+	if ((stream == 0) || (length < TP_RECORD_HEADER) || (rep_byte() != 'T') || (rep_byte() != 'P')) {
+		rep_pos = 0;
+		return;
+	}
+	for (i = 0; i < 7; i++, m++) {
+		v = rep_byte();
+		v |= (uint32_t) rep_byte() << 8;
+		v |= (uint32_t) rep_byte() << 16;
+		v |= (uint32_t) rep_byte() << 24;
+		*m = (int32_t) v; //sign of 32 bit, also if long is wider (host)
+	}
+	calc_transform();
+	rec_time = millis();
+	replay_samples();
 
-	//SPI speed-down
-#if !defined(SOFTWARE_SPI)
-	uint8_t spcr, spsr;
-	spcr = SPCR;
-	SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
-	spsr = SPSR;
-	SPSR = (1 << SPI2X); //clk*2 -> clk=Fcpu/8
+	return;
+}
+
+uint8_t ADS7846::isReplaying(void) {
+	return (rep_pos != 0);
+}
 #endif
 
-	//get pressure
+//-------------------- Private --------------------
+
+//n/d as rounded Q16 without 64 bit math: integer part, then 16 fraction bits by shift and subtract
+static long div_q16(long n, long d) {
+	unsigned long q, r;
+	uint8_t neg = 0, i;
+
+	if (d == 0) {
+		return 0;
+	}
+	if (n < 0) {
+		n = -n;
+		neg = 1;
+	}
+	if (d < 0) {
+		d = -d;
+		neg ^= 1;
+	}
+	q = n / d;
+	r = n % d;
+	for (i = 0; i < 16; i++) {
+		q <<= 1;
+		r <<= 1;
+		if (r >= (unsigned long) d) {
+			r -= d;
+			q |= 1;
+		}
+	}
+	if ((r << 1) >= (unsigned long) d) {
+		q++;
+	}
+
+	return neg ? -(long) q : (long) q;
+}
+
+//tp_matrix / div as Q16, orientation and rounding included: x' = (tp_x[0]*x + tp_x[1]*y + tp_x[2]) >> 16
+void ADS7846::calc_transform(void) {
+	long a, b, c, d, e, f;
+
+	a = div_q16(tp_matrix.a, tp_matrix.div);
+	b = div_q16(tp_matrix.b, tp_matrix.div);
+	c = div_q16(tp_matrix.c, tp_matrix.div);
+	d = div_q16(tp_matrix.d, tp_matrix.div);
+	e = div_q16(tp_matrix.e, tp_matrix.div);
+	f = div_q16(tp_matrix.f, tp_matrix.div);
+
+	switch (lcd_orientation) {
+	default: //0
+		tp_x[0] = a; tp_x[1] = b; tp_x[2] = c;
+		tp_y[0] = d; tp_y[1] = e; tp_y[2] = f;
+		break;
+	case 90: //x' = y, y' = width - x
+		tp_x[0] = d; tp_x[1] = e; tp_x[2] = f;
+		tp_y[0] = -a; tp_y[1] = -b; tp_y[2] = ((long) LCD_WIDTH << 16) - c;
+		break;
+	case 180: //x' = width - x, y' = height - y
+		tp_x[0] = -a; tp_x[1] = -b; tp_x[2] = ((long) LCD_WIDTH << 16) - c;
+		tp_y[0] = -d; tp_y[1] = -e; tp_y[2] = ((long) LCD_HEIGHT << 16) - f;
+		break;
+	case 270: //x' = height - y, y' = x
+		tp_x[0] = -d; tp_x[1] = -e; tp_x[2] = ((long) LCD_HEIGHT << 16) - f;
+		tp_y[0] = a; tp_y[1] = b; tp_y[2] = c;
+		break;
+	}
+	tp_x[2] += 0x8000; //+0.5
+	tp_y[2] += 0x8000;
+	tp_last.x = 0xFFFF; //recalculate lcd pos
+	tp_last.y = 0xFFFF;
+
+	return;
+}
+
+//pen state from the last sample, x/y stay at the last touched pos while not pressed
+void ADS7846::update_sample(void) {
+	uint8_t touched = (sample.pen == TP_PEN_DOWN) || (sample.pen == TP_PEN_MOVE);
+
+	if (pressure != 0) {
+		calibrate();
+		sample.x = lcd.x;
+		sample.y = lcd.y;
+		sample.x_raw = tp.x;
+		sample.y_raw = tp.y;
+		sample.pen = touched ? TP_PEN_MOVE : TP_PEN_DOWN;
+	} else {
+		sample.pen = touched ? TP_PEN_UP : TP_PEN_NONE;
+	}
+	sample.pressure = pressure;
+	sample.time = millis();
+
+	return;
+}
+
+//1 if a reading is due, else the last sample is kept (pen down/up reported once)
+uint8_t ADS7846::rd_due(void) {
+	uint16_t now = millis();
+
+	if ((uint16_t) (now - rd_time) < rd_period[(pen_down != 0) ? 1 : 0]) {
+		if (sample.pen == TP_PEN_DOWN) {
+			sample.pen = TP_PEN_MOVE;
+		} else if (sample.pen == TP_PEN_UP) {
+			sample.pen = TP_PEN_NONE;
+		}
+		return 0;
+	}
+	rd_time = now;
+
+	return 1;
+}
+
+//inside a transaction
+uint8_t ADS7846::rd_pressure(void) {
+	uint8_t a, b;
+
 	CS_ENABLE();
 	wr_spi(CMD_START | CMD_8BIT | CMD_DIFF | CMD_Z1_POS);
 	a = rd_spi();
 	wr_spi(CMD_START | CMD_8BIT | CMD_DIFF | CMD_Z2_POS);
 	b = 127 - rd_spi();
 	CS_DISABLE();
-	pressure = a + b;
 
-	if (pressure >= MIN_PRESSURE) {
-		for (x = 0, y = 0, i = 8; i != 0; i--) //8 samples
-				{
-			CS_ENABLE();
+	return a + b;
+}
+
+void ADS7846::rd_data(void) {
+	uint8_t a, b, i, p;
+	uint16_t x, y;
+#if (TP_SAMPLES > 1)
+	uint16_t xs[TP_SAMPLES], ys[TP_SAMPLES];
+#endif
+
+	SPIBus::beginTransaction(SPI_DEVICE_TP);
+
+	p = rd_pressure();
+
+	if (p < getThreshold()) {
+		if (p_idle < TP_PRESSURE_SETTLE) { //fading edge of a touch
+			p_idle++;
+		} else { //average of 16, light touches cannot raise it above TP_PRESSURE_MIN
+			p_noise += ((p < TP_PRESSURE_MIN) ? p : TP_PRESSURE_MIN) - (p_noise >> 4);
+		}
+		pressure = 0;
+		pen_down = 0;
+#if defined(TP_DROP_FIRST)
+	} else if (pen_down == 0) { //first reading after pen-down, the panel is not settled
+		pressure = 0;
+		pen_down = 1;
+		p_idle = 0;
+#endif
+#if (TP_PRESSURE_JUMP > 0)
+	} else if ((pen_down != 0) && (((p > p_last) ? (p - p_last) : (p_last - p)) > TP_PRESSURE_JUMP)) {
+		//inconsistent with the last reading: keep the last sample, a new first reading must be confirmed
+		if (pen_down == 1) {
+			pressure = 0;
+		}
+		p_idle = 0;
+#endif
+	} else {
+		pressure = p;
+		p_idle = 0;
+		CS_ENABLE();
+		for (i = 0; i < TP_SAMPLES; i++) {
 			//get X data
 			wr_spi(CMD_START | CMD_12BIT | CMD_DIFF | CMD_X_POS);
 			a = rd_spi();
 			b = rd_spi();
-			x += 1023 - ((a << 2) | (b >> 6)); //12bit: ((a<<4)|(b>>4)) //10bit: ((a<<2)|(b>>6))
+			x = 1023 - ((a << 2) | (b >> 6)); //12bit: ((a<<4)|(b>>4)) //10bit: ((a<<2)|(b>>6))
 			//get Y data
 			wr_spi(CMD_START | CMD_12BIT | CMD_DIFF | CMD_Y_POS);
 			a = rd_spi();
 			b = rd_spi();
-			y += ((a << 2) | (b >> 6)); //12bit: ((a<<4)|(b>>4)) //10bit: ((a<<2)|(b>>6))
-			CS_DISABLE();
+			y = ((a << 2) | (b >> 6)); //12bit: ((a<<4)|(b>>4)) //10bit: ((a<<2)|(b>>6))
+#if (TP_SAMPLES > 1)
+			xs[i] = x;
+			ys[i] = y;
+#endif
 		}
-		x >>= 3; //x/8
-		y >>= 3; //y/8
+		CS_DISABLE();
+#if (TP_SAMPLES > 1)
+		x = median(xs);
+		y = median(ys);
+#endif
 
 		if ((x >= 10) && (y >= 10)) {
+#if defined(TP_IIR)
+			iir_filter(&x, &y, (pen_down != 2));
+#endif
 			tp.x = x;
 			tp.y = y;
 		}
-	} else {
-		pressure = 0;
+		pen_down = 2;
 	}
+	p_last = p;
 
-	//restore SPI settings
-#if !defined(SOFTWARE_SPI)
-	SPCR = spcr;
-	SPSR = spsr;
-#endif
+	SPIBus::endTransaction();
 
 	return;
 }
 
-uint8_t ADS7846::rd_spi(void) {
-#if defined(SOFTWARE_SPI)
-	uint8_t bit, data;
-
-	MOSI_LOW();
-	for(data=0, bit=8; bit!=0; bit--)
-	{
-		CLK_HIGH();
-		data <<= 1;
-		if(MISO_READ())
-		{
-			data |= 1;
-		}
-		else
-		{
-			//data |= 0;
+#if (TP_SAMPLES > 1)
+//sorts v, TP_SAMPLES is small
+uint16_t ADS7846::median(uint16_t *v) {
+	uint8_t i, j;
+	uint16_t t;
+
+	for (i = 1; i < TP_SAMPLES; i++) {
+		t = v[i];
+		for (j = i; (j != 0) && (v[j - 1] > t); j--) {
+			v[j] = v[j - 1];
 		}
-		CLK_LOW();
+		v[j] = t;
 	}
-	return data;
 
-#else
-	SPDR = 0x00;
-	while (!(SPSR & (1 << SPIF)))
-		;
-	return SPDR;
+	return v[TP_SAMPLES / 2];
+}
+#endif
+
+#if defined(TP_IIR)
+//y += (x - y) * k/16, k = 4..16 rises with the movement
+void ADS7846::iir_filter(uint16_t *x, uint16_t *y, uint8_t reset) {
+	int16_t dx, dy;
+	uint16_t d;
+	uint8_t k;
+
+	if (reset) {
+		iir_x = *x << 4;
+		iir_y = *y << 4;
+		return;
+	}
+	dx = (int16_t) (*x << 4) - (int16_t) iir_x;
+	dy = (int16_t) (*y << 4) - (int16_t) iir_y;
+	d = ((dx < 0) ? -dx : dx) + ((dy < 0) ? -dy : dy); //raw << 4
+	if (d >= (TP_IIR_FAST << 4)) { //fast move: no smoothing
+		iir_x = *x << 4;
+		iir_y = *y << 4;
+		return;
+	}
+	k = 4 + ((d * 12) / (TP_IIR_FAST << 4));
+	iir_x += (dx * k) >> 4;
+	iir_y += (dy * k) >> 4;
+	*x = (iir_x + 8) >> 4;
+	*y = (iir_y + 8) >> 4;
+
+	return;
+}
 #endif
+
+#if defined(TP_RECORD)
+//x, y, p = values before rd_data()
+void ADS7846::record_sample(uint16_t x, uint16_t y, uint8_t p) {
+	uint16_t dt = millis() - rec_time;
+	uint8_t changed, buf[TP_RECORD_SAMPLE];
+
+	changed = (tp.x != x) || (tp.y != y) || (pressure != p);
+	if (!changed && (dt < 255)) {
+		return;
+	}
+	//the last state continues over long gaps
+	buf[0] = 255;
+	buf[1] = p;
+	buf[2] = x >> 2;
+	buf[3] = y >> 2;
+	buf[4] = ((x & 3) << 2) | (y & 3);
+	while (dt >= 255) {
+		rec_out->write(buf, TP_RECORD_SAMPLE);
+		rec_time += 255;
+		dt -= 255;
+	}
+	if (changed) {
+		buf[0] = dt;
+		buf[1] = pressure;
+		buf[2] = tp.x >> 2;
+		buf[3] = tp.y >> 2;
+		buf[4] = ((tp.x & 3) << 2) | (tp.y & 3);
+		rec_out->write(buf, TP_RECORD_SAMPLE);
+		rec_time += dt;
+	}
+
+	return;
 }
 
-void ADS7846::wr_spi(uint8_t data) {
-#if defined(SOFTWARE_SPI)
-	uint8_t mask;
+//applies all samples that are due
+void ADS7846::replay_samples(void) {
+	uint16_t now = millis();
+	uint8_t dt, b;
 
-	for(mask=0x80; mask!=0; mask>>=1)
-	{
-		CLK_LOW();
-		if(mask & data)
-		{
-			MOSI_HIGH();
+	while (rep_pos != 0) {
+		if ((rep_end - rep_pos) < TP_RECORD_SAMPLE) { //end of stream: released
+			rep_pos = 0;
+			pressure = 0;
+			break;
 		}
-		else
-		{
-			MOSI_LOW();
+		dt = rep_pgm ? pgm_read_byte(rep_pos) : *rep_pos;
+		if ((uint16_t) (now - rec_time) < dt) {
+			break;
 		}
-		CLK_HIGH();
+		rec_time += dt;
+		rep_pos++;
+		pressure = rep_byte();
+		tp.x = rep_byte() << 2;
+		tp.y = rep_byte() << 2;
+		b = rep_byte();
+		tp.x |= (b >> 2) & 3;
+		tp.y |= b & 3;
 	}
-	CLK_LOW();
 
-#else
-	SPDR = data;
-	while (!(SPSR & (1 << SPIF)))
-		;
+	return;
+}
+
+uint8_t ADS7846::rep_byte(void) {
+	return rep_pgm ? pgm_read_byte(rep_pos++) : *rep_pos++;
+}
 #endif
 
+uint8_t ADS7846::rd_spi(void) {
+	return SPIBus::transfer(0x00);
+}
+
+void ADS7846::wr_spi(uint8_t data) {
+	SPIBus::write(data);
+
 	return;
 }
@@ -12,6 +12,30 @@ extern "C" {
 #include "../MI0283QT2/MI0283QT2.h"
 
 
+//Touch filter of service()
+#define TP_SAMPLES    (3) //X/Y pairs per reading: 1, 3 or 5 (median)
+#define TP_DROP_FIRST     //the first reading after pen-down is reported as not pressed (edge outlier)
+//#define TP_IIR          //smoothing between readings, strong when resting, off when moving fast
+#define TP_IIR_FAST   (16) //raw units of movement (|dx|+|dy|) without smoothing
+
+//Touch detection: threshold = 2 * average pressure of the not pressed panel (noise) + margin
+#define TP_PRESSURE_MIN    (5)  //lowest threshold
+#define TP_PRESSURE_MAX    (20) //highest threshold
+#define TP_PRESSURE_MARGIN (3)
+#define TP_PRESSURE_SETTLE (8)  //readings below the threshold before they count as noise (pen up for a while)
+#define TP_PRESSURE_JUMP   (30) //readings with a larger pressure change are rejected (ghost touch), 0 = off
+
+//Readings/s of service() (setRate()), calls in between keep the last sample, 0 = every call
+#define TP_RATE_ACTIVE (100) //pressed
+#define TP_RATE_IDLE   (25)  //not pressed
+
+//Record the raw samples of service() to a Print (e.g. Serial) and replay them instead of the touch controller
+//#define TP_RECORD
+
+#define TP_RECORD_HEADER (2+(7*4)) //'T' 'P' calibration matrix (7 x int32 little endian)
+#define TP_RECORD_SAMPLE (5)       //ms since last sample (max. 255), pressure, x and y (10 bit)
+
+
 #define CAL_POINT_X1 (20)
 #define CAL_POINT_Y1 (20)
 #define CAL_POINT1   {CAL_POINT_X1,CAL_POINT_Y1}
@@ -38,6 +62,23 @@ typedef struct
 } CAL_POINT;
 
 
+#define TP_PEN_NONE (0) //not touched
+#define TP_PEN_DOWN (1) //first sample of a touch
+#define TP_PEN_MOVE (2) //touch continues (moved or not)
+#define TP_PEN_UP   (3) //first sample after a touch, x/y = last touched pos
+
+typedef struct
+{
+	uint16_t x;                     //calibrated pos (screen, current orientation)
+	uint16_t y;
+	uint16_t x_raw;                 //raw pos (touch panel)
+	uint16_t y_raw;
+	uint8_t pressure;
+	uint8_t pen;                    //TP_PEN_...
+	uint16_t time;                  //millis() of service(), 16 bit: use differences
+} TP_SAMPLE;
+
+
 typedef struct 
 {
 	long a;
@@ -54,12 +95,11 @@ class ADS7846
 {
   public:
     uint16_t lcd_orientation;       //lcd_orientation
-    TP_POINT lcd;                   //calibrated pos (screen)
+    TP_POINT lcd;                   //calibrated pos (screen, current orientation)
     TP_POINT tp;                    //raw pos (touch panel)
     TP_POINT tp_last;               //last raw pos (touch panel)
-    CAL_MATRIX tp_matrix;           //calibrate matrix
+    CAL_MATRIX tp_matrix;           //calibrate matrix (call setCalibration() or readCalibration() after changes)
     uint8_t pressure;               //touch panel pressure
-    //future: uint8_t action;                 //actions: move_right, move_left, move_up, move_down
 
     ADS7846();
     void init(void);
@@ -74,8 +114,17 @@ class ADS7846
     uint16_t getXraw(void);
     uint16_t getYraw(void);
     uint8_t getPressure(void);
+    uint8_t readPressure(void); //Z1/Z2 pressure read now, without filter and threshold (e.g. touched at boot?)
     void service(void);
+    void setRate(uint8_t active, uint8_t idle); //readings/s pressed and not pressed, 0 = every service() call
+    uint8_t getThreshold(void); //pressure threshold from the panel noise
+    const TP_SAMPLE *getSample(void); //result of the last service(), calibrated once
     uint16_t readChannel(uint8_t channel, uint8_t numberOfReadingsToIntegrate);
+#if defined(TP_RECORD)
+    void record(Print *out); //0 = stop, a sample is written if it changed or after 255ms
+    void replay(const uint8_t *stream, uint16_t length, uint8_t pgm); //stream from record(), in flash if pgm = 1
+    uint8_t isReplaying(void); //returns 1 until the end of the stream
+#endif
 
     // A/D input channel for readChannel()
 	#define CMD_TEMP0       (0x00)
@@ -90,7 +139,38 @@ class ADS7846
     #define CMD_TEMP1       (0x70)
 
   private:
+    TP_SAMPLE sample;
+    long tp_x[3], tp_y[3]; //tp_matrix as Q16 for the orientation, see calc_transform()
+    uint8_t pen_down; //0 = up, 1 = first reading dropped, 2 = down
+    uint8_t p_last; //pressure of the last reading (before threshold and rejection)
+    uint8_t p_idle; //readings below the threshold in a row, max. TP_PRESSURE_SETTLE
+    uint16_t p_noise; //average pressure while not pressed << 4, every reading clamped to TP_PRESSURE_MIN
+    uint16_t rd_period[2]; //ms between readings: not pressed, pressed
+    uint16_t rd_time; //millis() of the last reading
+#if defined(TP_IIR)
+    uint16_t iir_x, iir_y; //raw pos << 4
+#endif
+#if defined(TP_RECORD)
+    Print *rec_out;
+    const uint8_t *rep_pos, *rep_end; //rep_pos = 0: no replay
+    uint8_t rep_pgm;
+    uint16_t rec_time; //millis() of the last recorded or replayed sample
+
+    void record_sample(uint16_t x, uint16_t y, uint8_t p);
+    void replay_samples(void);
+    uint8_t rep_byte(void);
+#endif
+    void calc_transform(void);
+    void update_sample(void);
+    uint8_t rd_due(void);
     void rd_data(void);
+    uint8_t rd_pressure(void);
+#if (TP_SAMPLES > 1)
+    static uint16_t median(uint16_t *v);
+#endif
+#if defined(TP_IIR)
+    void iir_filter(uint16_t *x, uint16_t *y, uint8_t reset);
+#endif
     uint8_t rd_spi(void);
     void wr_spi(uint8_t data);
 };
@@ -16,7 +16,8 @@
  * 		getHeight()
  * 		getWidth()
  * 		fillRect()
- * 		drawText()
+ * 		drawChar()
+ * 		drawInteger()
  * 		drawPixel()
  * 		drawLine()
  * 		FONT_WIDTH
@@ -58,8 +59,8 @@ void Chart::init(const MI0283QT2 aTheLCD) {
 }
 #endif
 
-void Chart::initChartColors(const uint16_t aAxesColor, const uint16_t aGridColor, const uint16_t aLabelColor,
-		const uint16_t aBackgroundColor) {
+void Chart::initChartColors(const color_t aAxesColor, const color_t aGridColor, const color_t aLabelColor,
+		const color_t aBackgroundColor) {
 	mAxesColor = aAxesColor;
 	mGridColor = aGridColor;
 	mLabelColor = aLabelColor;
@@ -196,13 +197,53 @@ uint8_t Chart::drawAxes(bool aClearLabelsBefore) {
 	return tRetValue;
 }
 
+/*
+ * draws a label like ltoa() or dtostrf(aFloatValue, aMinStringWidth, aNumVarsAfterDecimal), but without a string buffer
+ */
+void Chart::drawLabel(uint16_t aPositionX, uint16_t aPositionY, bool aIsInt, long aIntValue, float aFloatValue,
+		uint8_t aMinStringWidth, uint8_t aNumVarsAfterDecimal) {
+	if (aIsInt) {
+		TFTDisplay.drawInteger(aPositionX, aPositionY, aIntValue, DEC, 1, mLabelColor, mChartBackgroundColor);
+		return;
+	}
+
+	// fixed point, rounded
+	unsigned long tScale = 1;
+	for (uint8_t i = 0; i < aNumVarsAfterDecimal; ++i) {
+		tScale *= 10;
+	}
+	bool tNegative = (aFloatValue < 0);
+	unsigned long tScaled = (unsigned long) ((tNegative ? -aFloatValue : aFloatValue) * tScale + 0.5);
+	unsigned long tIntegerPart = tScaled / tScale;
+
+	// right aligned
+	uint8_t tLength = tNegative + 1;
+	if (aNumVarsAfterDecimal != 0) {
+		tLength += 1 + aNumVarsAfterDecimal;
+	}
+	for (unsigned long tValue = tIntegerPart; tValue >= 10; tValue /= 10) {
+		tLength++;
+	}
+	for (; tLength < aMinStringWidth; tLength++) {
+		aPositionX = TFTDisplay.drawChar(aPositionX, aPositionY, ' ', 1, mLabelColor, mChartBackgroundColor);
+	}
+	if (tNegative) {
+		aPositionX = TFTDisplay.drawChar(aPositionX, aPositionY, '-', 1, mLabelColor, mChartBackgroundColor);
+	}
+	aPositionX = TFTDisplay.drawInteger(aPositionX, aPositionY, tIntegerPart, DEC, 1, ' ', 1, mLabelColor,
+			mChartBackgroundColor);
+	if (aNumVarsAfterDecimal != 0) {
+		aPositionX = TFTDisplay.drawChar(aPositionX, aPositionY, '.', 1, mLabelColor, mChartBackgroundColor);
+		TFTDisplay.drawInteger(aPositionX, aPositionY, tScaled % tScale, DEC, aNumVarsAfterDecimal, '0', 1, mLabelColor,
+				mChartBackgroundColor);
+	}
+}
+
 /**
  * render X AXIS only if integer or float increment value != 0
  */
 uint8_t Chart::drawXAxis(bool aClearLabelsBefore) {
 
-	char tLabelStringBuffer[32];
-
 // draw X line
 	TFTDisplay.fillRect(mPositionX - mAxesSize + 1, mPositionY, mPositionX + mWidthX - 1, mPositionY + mAxesSize - 1,
 			mAxesColor);
@@ -235,25 +276,19 @@ uint8_t Chart::drawXAxis(bool aClearLabelsBefore) {
 		// initialize both variables to avoid compiler warnings
 		long tValue = mXLabelStartValue.IntValue;
 		float tValueFloat = mXLabelStartValue.FloatValue;
-		if (mFlags & (1 << CHART_X_LABEL_INT)) {
-			ltoa(tValue, tLabelStringBuffer, 10);
-		} else {
-			dtostrf(tValueFloat, mXMinStringWidth, mXNumVarsAfterDecimal, tLabelStringBuffer);
-		}
-		TFTDisplay.drawText(mPositionX + tOffset, tNumberYTop, tLabelStringBuffer, 1, mLabelColor,
-				mChartBackgroundColor);
+		bool tIsInt = mFlags & (1 << CHART_X_LABEL_INT);
+		drawLabel(mPositionX + tOffset, tNumberYTop, tIsInt, tValue, tValueFloat, mXMinStringWidth,
+				mXNumVarsAfterDecimal);
 		tOffset += mGridXResolution;
 
 		for (; tOffset <= mWidthX; tOffset += mGridXResolution) {
-			if (mFlags & (1 << CHART_X_LABEL_INT)) {
+			if (tIsInt) {
 				tValue += mXLabelIncrementValue.IntValue;
-				ltoa(tValue, tLabelStringBuffer, 10);
 			} else {
 				tValueFloat += mXLabelIncrementValue.FloatValue;
-				dtostrf(tValueFloat, mXMinStringWidth, mXNumVarsAfterDecimal, tLabelStringBuffer);
 			}
-			TFTDisplay.drawText(mPositionX + tOffset, tNumberYTop, tLabelStringBuffer, 1, mLabelColor,
-					mChartBackgroundColor);
+			drawLabel(mPositionX + tOffset, tNumberYTop, tIsInt, tValue, tValueFloat, mXMinStringWidth,
+					mXNumVarsAfterDecimal);
 		}
 	}
 	return 0;
@@ -307,8 +342,6 @@ bool Chart::stepXLabelFloat(const bool aDoIncrement) {
  */
 uint8_t Chart::drawYAxis(bool aClearLabelsBefore) {
 
-	char tLabelStringBuffer[32];
-
 //draw y line
 	TFTDisplay.fillRect(mPositionX - mAxesSize + 1, mPositionY - mHeightY + 1, mPositionX, mPositionY - 1, mAxesColor);
 
@@ -340,29 +373,22 @@ uint8_t Chart::drawYAxis(bool aClearLabelsBefore) {
 					mPositionY - tOffset + FONT_HEIGHT, mChartBackgroundColor);
 		}
 
-		// convert to string
 		// initialize both variables to avoid compiler warnings
 		long tValue = mYLabelStartValue.IntValue;
 		float tValueFloat = mYLabelStartValue.FloatValue;
-		if (mFlags & (1 << CHART_Y_LABEL_INT)) {
-			ltoa(tValue, tLabelStringBuffer, 10);
-		} else {
-			dtostrf(tValueFloat, mYMinStringWidth, mYNumVarsAfterDecimal, tLabelStringBuffer);
-		}
-		TFTDisplay.drawText(tNumberXLeft, mPositionY - tOffset, tLabelStringBuffer, 1, mLabelColor,
-				mChartBackgroundColor);
+		bool tIsInt = mFlags & (1 << CHART_Y_LABEL_INT);
+		drawLabel(tNumberXLeft, mPositionY - tOffset, tIsInt, tValue, tValueFloat, mYMinStringWidth,
+				mYNumVarsAfterDecimal);
 		tOffset += mGridYResolution;
 
 		for (; tOffset <= mHeightY; tOffset += mGridYResolution) {
-			if (mFlags & (1 << CHART_Y_LABEL_INT)) {
+			if (tIsInt) {
 				tValue += mYLabelIncrementValue.IntValue;
-				ltoa(tValue, tLabelStringBuffer, 10);
 			} else {
 				tValueFloat += mYLabelIncrementValue.FloatValue;
-				dtostrf(tValueFloat, mYMinStringWidth, mYNumVarsAfterDecimal, tLabelStringBuffer);
 			}
-			TFTDisplay.drawText(tNumberXLeft, mPositionY - tOffset, tLabelStringBuffer, 1, mLabelColor,
-					mChartBackgroundColor);
+			drawLabel(tNumberXLeft, mPositionY - tOffset, tIsInt, tValue, tValueFloat, mYMinStringWidth,
+					mYNumVarsAfterDecimal);
 		}
 	}
 	return 0;
@@ -412,7 +438,7 @@ void Chart::clear(void) {
 /*
  * Draws the line and returns false if clipping occurs
  */
-bool Chart::drawChartData(uint8_t * aDataPointer, uint16_t aDataLength, const uint16_t aDataColor,
+bool Chart::drawChartData(uint8_t * aDataPointer, uint16_t aDataLength, const color_t aDataColor,
 		const uint8_t aMode) {
 
 	bool tRetValue = true;
@@ -432,6 +458,8 @@ bool Chart::drawChartData(uint8_t * aDataPointer, uint16_t aDataLength, const ui
 
 	uint16_t tXpos = mPositionX;
 
+	// do not overdraw axes or neighbours
+	uint8_t tClipFull = TFTDisplay.pushClip(mPositionX + 1, mPositionY - mHeightY + 1, mPositionX + mWidthX - 1, mPositionY);
 	for (; aDataLength > 0; aDataLength--) {
 		tValue = *aDataPointer++;
 		if (tValue > mHeightY - 1) {
@@ -450,6 +478,9 @@ bool Chart::drawChartData(uint8_t * aDataPointer, uint16_t aDataLength, const ui
 			TFTDisplay.drawLine(tXpos, mPositionY, tXpos, mPositionY - tValue, aDataColor);
 		}
 	}
+	if (!tClipFull) {
+		TFTDisplay.popClip();
+	}
 	return tRetValue;
 }
 
@@ -22,7 +22,7 @@
 #include <MI0283QT2.h>
 
 #define CHART_DEFAULT_AXES_COLOR 		COLOR_BLACK
-#define CHART_DEFAULT_GRID_COLOR 		RGB( 180, 180, 180)
+#define CHART_DEFAULT_GRID_COLOR 		COLOR_GRAY
 #define CHART_DEFAULT_BACKGROUND_COLOR  COLOR_WHITE
 #define CHART_DEFAULT_LABEL_COLOR  		COLOR_BLACK
 #define CHART_MAX_AXES_SIZE 			10
@@ -79,10 +79,10 @@ public:
 	void initYLabelFloat(const float aYLabelStartValue, const float aYLabelIncrementValue,
 			uint8_t aYMinStringWidthIncDecimalPoint, uint8_t aYNumVarsAfterDecimal);
 	float stepYLabelFloat(const bool aDoIncrement);
-	void initChartColors(const uint16_t aAxesColor, const uint16_t aGridColor, const uint16_t aLabelColor,
-			const uint16_t aBackgroundColor);
+	void initChartColors(const color_t aAxesColor, const color_t aGridColor, const color_t aLabelColor,
+			const color_t aBackgroundColor);
 	uint8_t drawChart(void);
-	bool drawChartData(uint8_t *aDataPointer, const uint16_t aDataLength, const uint16_t aDataColor,
+	bool drawChartData(uint8_t *aDataPointer, const uint16_t aDataLength, const color_t aDataColor,
 			const uint8_t aMode);
 	void drawGrid(void);
 	uint8_t drawXAxis(bool aClearLabelsBefore);
@@ -113,13 +113,13 @@ private:
 	uint16_t mPositionY;
 	uint16_t mWidthX;
 	uint16_t mHeightY;
-	uint16_t mChartBackgroundColor;
+	color_t mChartBackgroundColor;
 	uint8_t mAxesSize;
-	uint16_t mAxesColor;
+	color_t mAxesColor;
 	uint8_t mFlags;
 	uint8_t mGridXResolution;
 	uint8_t mGridYResolution;
-	uint16_t mGridColor;
+	color_t mGridColor;
 	int_float_union mXLabelStartValue;
 	int_float_union mXLabelIncrementValue;
 	int_float_union mYLabelStartValue;
@@ -129,9 +129,11 @@ private:
 	uint8_t mYNumVarsAfterDecimal;
 	uint8_t mXMinStringWidth;
 	uint8_t mYMinStringWidth;
-	uint16_t mLabelColor;
+	color_t mLabelColor;
 
 	uint8_t checkParameterValues();
+	void drawLabel(uint16_t aPositionX, uint16_t aPositionY, bool aIsInt, long aIntValue, float aFloatValue,
+			uint8_t aMinStringWidth, uint8_t aNumVarsAfterDecimal);
 };
 
 #endif /* CHART_H_ */
@@ -5,6 +5,7 @@ extern "C" {
 #include <avr/io.h>
 #include <avr/pgmspace.h>
 #include <util/delay.h>
+#include <avr/interrupt.h>
 #ifdef __cplusplus
 }
 #endif
@@ -14,166 +15,434 @@ extern "C" {
 #include "WProgram.h"
 #endif
 #include "../digitalWriteFast/digitalWriteFast.h"
+#include "../SPIBus/SPIBus.h"
 #include "fonts.h"
 #include "MI0283QT2.h"
 
 #define PRINT_STARTX    (2)
 #define PRINT_STARTY    (2)
 
-#define LCD_ID          (0)
-#define LCD_DATA        ((0x72)|(LCD_ID<<2))
-#define LCD_REGISTER    ((0x70)|(LCD_ID<<2))
-
-//#define SOFTWARE_SPI
-
-#if (defined(__AVR_ATmega1280__) || \
-     defined(__AVR_ATmega1281__) || \
-     defined(__AVR_ATmega2560__) || \
-     defined(__AVR_ATmega2561__))      //--- Arduino Mega ---
-# define LED_PIN        (9) //PH6: OC2B
-# define RST_PIN        (8)
-# define CS_PIN         (7)
-# if defined(SOFTWARE_SPI)
-#  define MOSI_PIN      (11)
-#  define MISO_PIN      (12)
-#  define CLK_PIN       (13)
-# else
-#  define MOSI_PIN      (51)
-#  define MISO_PIN      (50)
-#  define CLK_PIN       (52)
+//reads a character from RAM or flash
+static inline char text_char(const char *s, uint8_t pgm) {
+	if (pgm) {
+		return pgm_read_byte(s);
+	}
+	return *s;
+}
+
+//one row of a glyph, first pixel = MSB
+static inline glyph_line_t glyph_row(uint8_t c, uint8_t row) {
+#if FONT_WIDTH <= 8
+	return pgm_read_byte(&font_PGM[((c - FONT_START) * FONT_HEIGHT) + row]);
+#elif FONT_WIDTH <= 16
+	return pgm_read_word(&font_PGM[(((c - FONT_START) * FONT_HEIGHT) + row) * 2]);
+#elif FONT_WIDTH <= 32
+	return pgm_read_dword(&font_PGM[(((c - FONT_START) * FONT_HEIGHT) + row) * 4]);
+#endif
+}
+
+//Breaks the first line of s after at most llen characters, at a space if possible.
+//Returns the length of the line in bytes, *chars = characters to draw, *next = start of the next line.
+static uint8_t text_layout(const char *s, uint8_t pgm, uint8_t llen, uint8_t *chars, const char **next) {
+	uint8_t i, n, brk, brk_chars;
+	char c;
+
+	for (i = 0, n = 0, brk = 0, brk_chars = 0;; i++) {
+		c = text_char(s + i, pgm);
+		if ((c == 0) || (c == '\n')) {
+			*next = (c == 0) ? (s + i) : (s + i + 1);
+			break;
+		}
+		if (c == '\r') //skip
+		{
+			continue;
+		}
+		if ((n == llen) || (i == 0xFF)) //line full
+		{
+			if ((c != ' ') && (brk != 0)) //move word to next line
+			{
+				i = brk;
+				n = brk_chars;
+			}
+			*next = s + i;
+			break;
+		}
+		n++;
+		if (c == ' ') {
+			brk = i + 1;
+			brk_chars = n;
+		}
+	}
+	*chars = n;
+
+	return i;
+}
+
+#include "../SPIBus/pins.h"
+
+#define LCD_REGISTER    (lcd_start)        //start byte: 0x70 | LCD_ID<<2
+#define LCD_DATA        (lcd_start | 0x02) //RS=1
+
+#define LED_ENABLE()    digitalWriteFast(LCD_LED_PIN, HIGH)
+#define LED_DISABLE()   digitalWriteFast(LCD_LED_PIN, LOW)
+
+#define RST_DISABLE()   digitalWriteFast(LCD_RST_PIN, HIGH)
+#define RST_ENABLE()    digitalWriteFast(LCD_RST_PIN, LOW)
+
+//Display on USART0 in Master SPI mode: TXD=SDI, XCK=SCL (Arduino Uno and 644, Serial is not available).
+//UDR0 is double-buffered, so the next byte is written while the last one is shifted out without a gap.
+//#define LCD_USART_SPI
+
+#if defined(LCD_USART_SPI)
+# if !defined(USART_XCK_PIN)
+#  error "LCD_USART_SPI: XCK0 is not available on this board"
 # endif
+# define BUS_BEGIN()    //the USART is used by the display only
+# define BUS_END()      usart_end() //wait until the last byte is shifted out
+#else
+# define BUS_BEGIN()    SPIBus::beginTransaction(SPI_DEVICE_LCD)
+# define BUS_END()      SPIBus::endTransaction()
+#endif
+
+#if defined(LCD_CS1_PIN) //one CS line per display
+# define CS_DISABLE()   do { BUS_END(); \
+                             if (lcd_start & 0x04) { digitalWriteFast(LCD_CS1_PIN, HIGH); } else { digitalWriteFast(LCD_CS_PIN, HIGH); } } while (0)
+# define CS_ENABLE()    do { BUS_BEGIN(); \
+                             if (lcd_start & 0x04) { digitalWriteFast(LCD_CS1_PIN, LOW); } else { digitalWriteFast(LCD_CS_PIN, LOW); } } while (0)
+#else                    //shared CS line, the display is selected by the LCD_ID in the start byte
+# define CS_DISABLE()   do { BUS_END(); digitalWriteFast(LCD_CS_PIN, HIGH); } while (0)
+# define CS_ENABLE()    do { BUS_BEGIN(); digitalWriteFast(LCD_CS_PIN, LOW); } while (0)
+#endif
+
+#if defined(LCD_USART_SPI)
+//waits for a free transmit buffer
+static inline void usart_tx(uint8_t data) {
+	while (!(UCSR0A & (1 << UDRE0)))
+		;
+	UDR0 = data;
+}
+
+//Once per burst: with UDRE0 set the last byte is in the shift register or already out.
+//TXC0 is cleared with interrupts off, a byte still shifting sets it again within 8 XCK = 16 * (UBRR0 + 1) clocks.
+//A byte that was already out never sets it -> the wait ends after that time (4 clocks per loop at least).
+static inline void usart_end(void) {
+	uint8_t sreg;
+	uint16_t n;
+
+	while (!(UCSR0A & (1 << UDRE0)))
+		;
+	sreg = SREG;
+	cli();
+	UCSR0A = (1 << TXC0); //clear
+	n = (UBRR0 + 1) << 2;
+	while (!(UCSR0A & (1 << TXC0)) && --n)
+		;
+	SREG = sreg;
+}
+#endif
+
+//floor(sqrt(v)), bit by bit
+static uint16_t isqrt(uint32_t v) {
+	uint32_t root = 0, bit = 1UL << 30;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (v >= (root + bit)) {
+			v -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
 
-#elif (defined(__AVR_ATmega644__) || \
-       defined(__AVR_ATmega644P__))    //--- Arduino 644 (www.mafu-foto.de) ---
-# define LED_PIN        (3) //PB3: OC0
-# define RST_PIN        (12)
-# define CS_PIN         (13)
-# define MOSI_PIN       (5)
-# define MISO_PIN       (6)
-# define CLK_PIN        (7)
-
-#else                                  //--- Arduino Uno ---
-# define LED_PIN        (9) //PB1: OC1
-# define RST_PIN        (8)
-# define CS_PIN         (7)
-# define MOSI_PIN       (11)
-# define MISO_PIN       (12)
-# define CLK_PIN        (13)
+	return root;
+}
 
+static void lcd_clock(uint8_t clock_div) {
+#if defined(LCD_USART_SPI)
+	UBRR0 = (clock_div >> 1) - 1; //baud = Fcpu / (2 * (UBRR0 + 1))
+#else
+	SPIBus::setClock(SPI_DEVICE_LCD, clock_div);
 #endif
+}
+
+//init sequence: register, value, delay in ms after the write
+#define INIT_RST_LOW    (0xFD) //pseudo registers, not used by the HX8347
+#define INIT_RST_HIGH   (0xFE)
+#define INIT_END        (0xFF)
+#define INIT_DONE       (0xFF) //init_pos
+
+#define CLOCK_FALLBACK  (4) //LCD_CLOCK_AUTO without readback (SDO not connected, USART or software SPI)
+
+static const prog_uint8_t init_PGM[] PROGMEM = {
+	//reset
+	INIT_RST_LOW, 0x00, 50,
+	INIT_RST_HIGH, 0x00, 50,
+
+	//driving ability
+	0xEA, 0x00, 0,
+	0xEB, 0x20, 0,
+	0xEC, 0x0C, 0,
+	0xED, 0xC4, 0,
+	0xE8, 0x40, 0,
+	0xE9, 0x38, 0,
+	0xF1, 0x01, 0,
+	0xF2, 0x10, 0,
+	0x27, 0xA3, 0,
+
+	//power voltage
+	0x1B, 0x1B, 0,
+	0x1A, 0x01, 0,
+	0x24, 0x2F, 0,
+	0x25, 0x57, 0,
 
-#define LED_ENABLE()    digitalWriteFast(LED_PIN, HIGH)
-#define LED_DISABLE()   digitalWriteFast(LED_PIN, LOW)
+	//VCOM offset
+	0x23, 0x8D, 0, //for flicker adjust
 
-#define RST_DISABLE()   digitalWriteFast(RST_PIN, HIGH)
-#define RST_ENABLE()    digitalWriteFast(RST_PIN, LOW)
+	//power on
+	0x18, 0x36, 0,
+	0x19, 0x01, 0, //start osc
+	0x01, 0x00, 0, //wakeup
+	0x1F, 0x88, 5,
+	0x1F, 0x80, 5,
+	0x1F, 0x90, 5,
+	0x1F, 0xD0, 5,
 
-#define CS_DISABLE()    digitalWriteFast(CS_PIN, HIGH)
-#define CS_ENABLE()     digitalWriteFast(CS_PIN, LOW)
+	//color selection
+	0x17, 0x05, 0, //0x05=65k, 0x06=262k
 
-#define MOSI_HIGH()     digitalWriteFast(MOSI_PIN, HIGH)
-#define MOSI_LOW()      digitalWriteFast(MOSI_PIN, LOW)
+	//panel characteristic
+	0x36, 0x00, 0,
 
-#define MISO_READ()     digitalReadFast(MISO_PIN)
+	//display on
+	0x28, 0x38, 40,
+	0x28, 0x3C, 0,
+
+	INIT_END
+};
+
+#if defined(LCD_PROFILE)
+LCD_PROFILE_DATA MI0283QT2::profile;
+
+//times the outermost primitive, nested calls (e.g. drawText() -> drawChar()) are counted for the caller
+class ProfileScope
+{
+  public:
+    ProfileScope(uint8_t id)
+    {
+      if (MI0283QT2::profile.depth++ == 0)
+      {
+        MI0283QT2::profile.current = id;
+        MI0283QT2::profile.primitive[id].calls++;
+        MI0283QT2::profile.start = micros();
+      }
+    }
+    ~ProfileScope()
+    {
+      if (--MI0283QT2::profile.depth == 0)
+      {
+        MI0283QT2::profile.primitive[MI0283QT2::profile.current].us += micros() - MI0283QT2::profile.start;
+      }
+    }
+};
+# define PROFILE(id)       ProfileScope profile_scope(id)
+# define PROFILE_PIXELS(n) do { if (profile.depth) { profile.primitive[profile.current].pixels += (n); } } while (0)
+# define PROFILE_BYTES(n)  profile.spi_bytes += (n)
+# define PROFILE_AREA()    profile.areas++
+#else
+# define PROFILE(id)
+# define PROFILE_PIXELS(n)
+# define PROFILE_BYTES(n)
+# define PROFILE_AREA()
+#endif
 
-#define CLK_HIGH()      digitalWriteFast(CLK_PIN, HIGH)
-#define CLK_LOW()       digitalWriteFast(CLK_PIN, LOW)
+#if defined(LCD_PALETTE)
+uint16_t MI0283QT2::palette[LCD_PALETTE_SIZE] = { RGB(255,255,255), RGB(  0,  0,  0), RGB(255,  0,  0),
+		RGB(  0,255,  0), RGB(  0,  0,255), RGB(255,255,  0), RGB(180,180,180) };
+#endif
 
 //-------------------- Constructor --------------------
 
-MI0283QT2::MI0283QT2(void) {
+MI0283QT2::MI0283QT2(uint8_t id) {
+	lcd_start = 0x70 | ((id & 0x01) << 2);
+	init_pos = INIT_DONE;
+
 	return;
 }
 
 //-------------------- Public --------------------
 
 void MI0283QT2::init(uint8_t clock_div) {
-	//init pins
-	pinMode(LED_PIN, OUTPUT);
-	digitalWriteFast(LED_PIN, LOW);
-	led(50);
-	pinMode(RST_PIN, OUTPUT);
-	digitalWriteFast(RST_PIN, LOW);
-	pinMode(CS_PIN, OUTPUT);
-	digitalWriteFast(CS_PIN, HIGH);
-	pinMode(CLK_PIN, OUTPUT);
-	pinMode(MOSI_PIN, OUTPUT);
-	pinMode(MISO_PIN, INPUT);
-	digitalWriteFast(MISO_PIN, HIGH);
-	//pull-up
-
-#if !defined(SOFTWARE_SPI)
-	//SS has to be output or input with pull-up
-# if (defined(__AVR_ATmega1280__) || \
-      defined(__AVR_ATmega1281__) || \
-      defined(__AVR_ATmega2560__) || \
-      defined(__AVR_ATmega2561__))     //--- Arduino Mega ---
-#  define SS_PORTBIT (0) //PB0
-# elif (defined(__AVR_ATmega644__) || \
-        defined(__AVR_ATmega644P__))   //--- Arduino 644 ---
-#  define SS_PORTBIT (4) //PB4
-# else                                 //--- Arduino Uno ---
-#  define SS_PORTBIT (2) //PB2
-# endif
-	if (!(DDRB & (1 << SS_PORTBIT))) //SS is input
-	{
-		PORTB |= (1 << SS_PORTBIT); //pull-up on
+	initStart(clock_div);
+	while (initService()) {
+		;
 	}
 
-	//init hardware spi
-	switch (clock_div) {
-	case 2:
-		SPCR = (1 << SPE) | (1 << MSTR); //enable SPI, Master, clk=Fcpu/4
-		SPSR = (1 << SPI2X); //clk*2 = Fcpu/2
-		break;
-	case 4:
-		SPCR = (1 << SPE) | (1 << MSTR); //enable SPI, Master, clk=Fcpu/4
-		SPSR = (0 << SPI2X); //clk*2 = off
-		break;
-	case 8:
-		SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
-		SPSR = (1 << SPI2X); //clk*2 = Fcpu/8
-		break;
-	case 16:
-		SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
-		SPSR = (0 << SPI2X); //clk*2 = off
-		break;
-	case 32:
-		SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR1); //enable SPI, Master, clk=Fcpu/64
-		SPSR = (1 << SPI2X); //clk*2 = Fcpu/32
-		break;
-	}
-#endif
+	return;
+}
 
-	//reset display
-	reset();
+void MI0283QT2::initStart(uint8_t clock_div) {
+	//init pins
+	pinMode(LCD_LED_PIN, OUTPUT);
+	digitalWriteFast(LCD_LED_PIN, LOW);
+	led(50);
+	pinMode(LCD_RST_PIN, OUTPUT);
+	digitalWriteFast(LCD_RST_PIN, LOW);
+	pinMode(LCD_CS_PIN, OUTPUT);
+	digitalWriteFast(LCD_CS_PIN, HIGH);
+#if defined(LCD_CS1_PIN)
+	pinMode(LCD_CS1_PIN, OUTPUT);
+	digitalWriteFast(LCD_CS1_PIN, HIGH);
+#endif
+#if defined(LCD_USART_SPI)
+	pinMode(USART_XCK_PIN, OUTPUT); //XCK output -> master
+	pinMode(USART_TXD_PIN, OUTPUT);
+	UBRR0 = 0; //has to be zero when the transmitter is enabled
+	UCSR0C = (1 << UMSEL01) | (1 << UMSEL00); //Master SPI, mode 0, MSB first
+	UCSR0B = (1 << TXEN0);
+#else
+	SPIBus::begin();
+#endif
 	p_size = 0;
+#if defined(PRINT_BUFFERED)
+	p_len = 0;
+#endif
 	p_fg = COLOR_BLACK;
 	p_bg = COLOR_WHITE;
 
-	// write upper y values to zero
-	wr_cmd(0x06, 0); //set y0 upper byte
-	wr_cmd(0x08, 0); //set y1 upper byte
+	//init sequence with clk=Fcpu/8, then switch to clock_div
+	lcd_clock(8);
+	init_clock = clock_div;
+	init_pos = 0;
+	init_time = millis();
+	CS_DISABLE();
+
+	initService(); //first step: reset low, the caller works while it is held
+
+	return;
+}
+
+uint8_t MI0283QT2::initService(void) {
+	uint8_t reg, param, ms;
+
+	while (init_pos != INIT_DONE) {
+		if ((int16_t) ((uint16_t) millis() - init_time) < 0) //delay of the last step is running
+		{
+			return 1;
+		}
+
+		reg = pgm_read_byte(&init_PGM[init_pos++]);
+		if (reg == INIT_END) {
+			//display options
+			setOrientation(0);
+
+			if (init_clock == LCD_CLOCK_AUTO) {
+				init_clock = clock_calibrate();
+			} else {
+				lcd_clock(init_clock);
+			}
+
+			// write upper y values to zero
+			wr_cmd(0x06, 0); //set y0 upper byte
+			wr_cmd(0x08, 0); //set y1 upper byte
+
+			init_pos = INIT_DONE;
+			break;
+		}
+		param = pgm_read_byte(&init_PGM[init_pos++]);
+		ms = pgm_read_byte(&init_PGM[init_pos++]);
+
+		switch (reg) {
+		case INIT_RST_LOW:
+			RST_ENABLE();
+			break;
+		case INIT_RST_HIGH:
+			RST_DISABLE();
+			break;
+		default:
+			wr_cmd(reg, param);
+			break;
+		}
+		if (ms != 0) {
+			init_time = (uint16_t) millis() + ms + 1; //+1: at least ms
+		}
+	}
+
+	return 0;
+}
+
+#if defined(LCD_PROFILE)
+void MI0283QT2::profileReset(void) {
+	memset(&profile, 0, sizeof(profile));
 
 	return;
 }
+#endif
+
+uint8_t MI0283QT2::getClock(void) {
+	return init_clock;
+}
+
+uint32_t MI0283QT2::measureFillRate(void) {
+	uint32_t t;
+
+	setArea(0, 0, 0, 0); //8 lines of pixels into one, the address wraps -> nothing visible but the top left pixel
+	t = micros();
+	draw_repeat(COLOR_TO_RGB565(COLOR_BLACK), (uint32_t) lcd_width * 8);
+	t = micros() - t;
+	if (t == 0) {
+		return 0;
+	}
+
+	return ((uint32_t) lcd_width * 8 * 1000000UL) / t;
+}
 
 void MI0283QT2::led(uint8_t power) {
 	if (power == 0) //off
 			{
-		analogWrite(LED_PIN, 0);
+		analogWrite(LCD_LED_PIN, 0);
 		LED_DISABLE();
 	} else if (power >= 100) //100%
 			{
-		analogWrite(LED_PIN, 255);
+		analogWrite(LCD_LED_PIN, 255);
 		LED_ENABLE();
 	} else //1...99%
 	{
-		analogWrite(LED_PIN, (uint16_t) power * 255 / 100);
+		analogWrite(LCD_LED_PIN, (uint16_t) power * 255 / 100);
+	}
+
+	return;
+}
+
+#if defined(LCD_PALETTE)
+/*
+ * Palette entries are expanded to RGB565 at draw time,
+ * so changing an entry and redrawing recolors every widget using it (e.g. night mode)
+ */
+void MI0283QT2::setPaletteColor(uint8_t index, uint16_t rgb565) {
+	palette[index & (LCD_PALETTE_SIZE - 1)] = rgb565;
+
+	return;
+}
+
+uint16_t MI0283QT2::getPaletteColor(uint8_t index) {
+	return palette[index & (LCD_PALETTE_SIZE - 1)];
+}
+
+/*
+ * loads count entries starting at index first from a PROGMEM table (e.g. a day or night theme)
+ */
+void MI0283QT2::setPalettePGM(const prog_uint16_t *p, uint8_t first, uint8_t count) {
+	for (; count != 0; count--) {
+		palette[first++ & (LCD_PALETTE_SIZE - 1)] = pgm_read_word(p++);
 	}
 
 	return;
 }
+#endif
 
 void MI0283QT2::setOrientation(uint16_t o) {
 	switch (o) {
@@ -207,6 +476,7 @@ void MI0283QT2::setOrientation(uint16_t o) {
 	}
 
 	setArea(0, 0, lcd_width - 1, lcd_height - 1);
+	resetClip();
 
 	p_x = PRINT_STARTX;
 	p_y = PRINT_STARTY;
@@ -226,6 +496,7 @@ void MI0283QT2::setArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
 	if ((x1 >= lcd_width) || (y1 >= lcd_height)) {
 		return;
 	}
+	PROFILE_AREA();
 
 	wr_cmd(0x03, (x0 >> 0)); //set x0
 	wr_cmd(0x02, (x0 >> 8)); //set x0
@@ -245,23 +516,67 @@ void MI0283QT2::setCursor(uint16_t x, uint16_t y) {
 	return;
 }
 
-void MI0283QT2::clear(uint16_t color) {
-	uint16_t size;
+//the new clip window is the intersection with the current one
+uint8_t MI0283QT2::pushClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+	int16_t tmp;
 
-	setArea(0, 0, lcd_width - 1, lcd_height - 1);
+	if (clip_depth >= LCD_CLIP_DEPTH) {
+		return 1;
+	}
+	clip_stack[clip_depth++] = clip;
 
-	drawStart();
-	for (size = (320UL * 240UL / 8UL); size != 0; size--) {
-		draw(color); //1
-		draw(color); //2
-		draw(color); //3
-		draw(color); //4
-		draw(color); //5
-		draw(color); //6
-		draw(color); //7
-		draw(color); //8
+	if (x0 > x1) {
+		tmp = x0;
+		x0 = x1;
+		x1 = tmp;
 	}
-	drawStop();
+	if (y0 > y1) {
+		tmp = y0;
+		y0 = y1;
+		y1 = tmp;
+	}
+
+	if (x0 > clip.x0) {
+		clip.x0 = x0;
+	}
+	if (y0 > clip.y0) {
+		clip.y0 = y0;
+	}
+	if (x1 < clip.x1) {
+		clip.x1 = x1;
+	}
+	if (y1 < clip.y1) {
+		clip.y1 = y1;
+	}
+
+	return 0;
+}
+
+void MI0283QT2::popClip(void) {
+	if (clip_depth != 0) {
+		clip = clip_stack[--clip_depth];
+	}
+
+	return;
+}
+
+void MI0283QT2::resetClip(void) {
+	clip_depth = 0;
+	clip.x0 = 0;
+	clip.y0 = 0;
+	clip.x1 = lcd_width - 1;
+	clip.y1 = lcd_height - 1;
+
+	return;
+}
+
+void MI0283QT2::clear(color_t color) {
+	PROFILE(LCD_PROFILE_FILL);
+	if ((clip.x0 > clip.x1) || (clip.y0 > clip.y1)) {
+		return;
+	}
+
+	fill_area(clip.x0, clip.y0, clip.x1, clip.y1, COLOR_TO_RGB565(color));
 
 	return;
 }
@@ -279,8 +594,15 @@ void MI0283QT2::drawStart(void) {
 }
 
 inline void MI0283QT2::draw(uint16_t color) {
+	PROFILE_PIXELS(1);
+#if defined(LCD_USART_SPI) //plain writes in bursts, TXC0 is handled once in CS_DISABLE()
+	usart_tx(color >> 8);
+	usart_tx(color);
+	PROFILE_BYTES(2);
+#else
 	wr_spi(color >> 8);
 	wr_spi(color);
+#endif
 
 	return;
 }
@@ -291,15 +613,16 @@ inline void MI0283QT2::drawStop(void) {
 	return;
 }
 
-void MI0283QT2::drawPixel(uint16_t x0, uint16_t y0, uint16_t color) {
-	if ((x0 >= lcd_width) || (y0 >= lcd_height)) {
+void MI0283QT2::drawPixel(uint16_t x0, uint16_t y0, color_t color) {
+	PROFILE(LCD_PROFILE_PIXEL);
+	if ((x0 < (uint16_t) clip.x0) || (x0 > (uint16_t) clip.x1) || (y0 < (uint16_t) clip.y0) || (y0 > (uint16_t) clip.y1)) {
 		return;
 	}
 
 	setArea(x0, y0, x0, y0);
 
 	drawStart();
-	draw(color);
+	draw(COLOR_TO_RGB565(color));
 	drawStop();
 
 	return;
@@ -308,10 +631,15 @@ void MI0283QT2::drawPixel(uint16_t x0, uint16_t y0, uint16_t color) {
 /*
  * needs an TFTDisplay.setArea(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT - 1) first.
  */
-void MI0283QT2::drawPixelFast(uint16_t x0, uint8_t y0, uint16_t color) {
+void MI0283QT2::drawPixelFast(uint16_t x0, uint8_t y0, color_t color) {
+	PROFILE(LCD_PROFILE_PIXEL);
 	uint8_t xUpper;
 	static uint8_t lastXUpper;
 
+	if ((x0 < (uint16_t) clip.x0) || (x0 > (uint16_t) clip.x1) || (y0 < (uint16_t) clip.y0) || (y0 > (uint16_t) clip.y1)) {
+		return;
+	}
+
 	// set area fast
 	wr_cmd(0x03, (x0 >> 0)); //set x low byte
 	xUpper = (x0 >> 8);
@@ -323,7 +651,7 @@ void MI0283QT2::drawPixelFast(uint16_t x0, uint8_t y0, uint16_t color) {
 	wr_cmd(0x07, (y0 >> 0)); //set y low byte - y high byte is always 0
 
 	drawStart();
-	draw(color);
+	draw(COLOR_TO_RGB565(color));
 	drawStop();
 
 	return;
@@ -334,8 +662,9 @@ void MI0283QT2::drawPixelFast(uint16_t x0, uint8_t y0, uint16_t color) {
  * draws a line only from x to x+1
  * first pixel is omitted because it is drawn by preceeding line
  */
-void MI0283QT2::drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, uint16_t color) {
-	uint8_t i;
+void MI0283QT2::drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, color_t color) {
+	PROFILE(LCD_PROFILE_LINE);
+	uint16_t rgb = COLOR_TO_RGB565(color);
 	bool up = true;
 	//calculate direction
 	int16_t deltaY = y1 - y0;
@@ -351,40 +680,23 @@ void MI0283QT2::drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, uint16_t
 		if (up) {
 			if (deltaY1 > 0) {
 				// first pixel is drawn by preceeding line :-)
-				setArea(x0, y0 + 1, x0, y0 + deltaY1);
-				drawStart();
-				for (i = deltaY1; i != 0; i--) {
-					draw(color);
-				}
-				drawStop();
-			}
-			setArea(x0 + 1, y0 + deltaY1 + 1, x0 + 1, y1);
-			drawStart();
-			for (i = deltaY2 + 1; i != 0; i--) {
-				draw(color);
+				draw_vspan(x0, y0 + 1, y0 + deltaY1, rgb);
 			}
-			drawStop();
+			draw_vspan(x0 + 1, y0 + deltaY1 + 1, y0 + deltaY1 + deltaY2 + 1, rgb);
 		} else {
 			if (deltaY1 > 0) {
-				setArea(x0, y0 - deltaY1, x0, y0 - 1);
-				drawStart();
-				for (i = deltaY1; i != 0; i--) {
-					draw(color);
-				}
-				drawStop();
-			}
-			setArea(x0 + 1, y1, x0 + 1, y0 - deltaY1 - 1);
-			drawStart();
-			for (i = deltaY2 + 1; i != 0; i--) {
-				draw(color);
+				draw_vspan(x0, y0 - deltaY1, y0 - 1, rgb);
 			}
-			drawStop();
+			draw_vspan(x0 + 1, y0 - deltaY1 - deltaY2 - 1, y0 - deltaY1 - 1, rgb);
 		}
 	}
 }
 
-void MI0283QT2::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-	int16_t dx, dy, dx2, dy2, err, stepx, stepy;
+//Bresenham, pixels with the same y (x major) or the same x (y major) are sent as one run
+void MI0283QT2::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color) {
+	PROFILE(LCD_PROFILE_LINE);
+	int16_t dx, dy, dx2, dy2, err, stepx, stepy, start;
+	uint16_t rgb = COLOR_TO_RGB565(color);
 
 	if (x0 >= lcd_width) {
 		x0 = lcd_width - 1;
@@ -418,39 +730,50 @@ void MI0283QT2::drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uin
 		} else {
 			stepy = +1;
 		}
+		//outside of clip window
+		if ((((stepx > 0) ? x0 : x1) > clip.x1) || (((stepx > 0) ? x1 : x0) < clip.x0)
+				|| (((stepy > 0) ? y0 : y1) > clip.y1) || (((stepy > 0) ? y1 : y0) < clip.y0)) {
+			return;
+		}
 		dx2 = dx << 1;
 		dy2 = dy << 1;
 		//draw line
-		drawPixel(x0, y0, color);
 		if (dx > dy) {
 			err = dy2 - dx;
+			start = x0;
 			while (x0 != x1) {
 				if (err >= 0) {
+					draw_hspan(((stepx > 0) ? start : x0), ((stepx > 0) ? x0 : start), y0, rgb);
 					y0 += stepy;
 					err -= dx2;
+					start = x0 + stepx;
 				}
 				x0 += stepx;
 				err += dy2;
-				drawPixel(x0, y0, color);
 			}
+			draw_hspan(((stepx > 0) ? start : x0), ((stepx > 0) ? x0 : start), y0, rgb);
 		} else {
 			err = dx2 - dy;
+			start = y0;
 			while (y0 != y1) {
 				if (err >= 0) {
+					draw_vspan(x0, ((stepy > 0) ? start : y0), ((stepy > 0) ? y0 : start), rgb);
 					x0 += stepx;
 					err -= dy2;
+					start = y0 + stepy;
 				}
 				y0 += stepy;
 				err += dx2;
-				drawPixel(x0, y0, color);
 			}
+			draw_vspan(x0, ((stepy > 0) ? start : y0), ((stepy > 0) ? y0 : start), rgb);
 		}
 	}
 
 	return;
 }
 
-void MI0283QT2::drawRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
+void MI0283QT2::drawRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color) {
+	PROFILE(LCD_PROFILE_LINE);
 	fillRect(x0, y0, x0, y1, color);
 	fillRect(x0, y1, x1, y1, color);
 	fillRect(x1, y0, x1, y1, color);
@@ -459,9 +782,9 @@ void MI0283QT2::drawRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uin
 	return;
 }
 
-void MI0283QT2::fillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color) {
-	uint32_t size;
-	uint16_t tmp, i;
+void MI0283QT2::fillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color) {
+	PROFILE(LCD_PROFILE_FILL);
+	uint16_t tmp;
 
 	if (x0 > x1) {
 		tmp = x0;
@@ -474,89 +797,93 @@ void MI0283QT2::fillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uin
 		y1 = tmp;
 	}
 
-	if (x1 >= lcd_width) {
-		x1 = lcd_width - 1;
+	if (x0 < (uint16_t) clip.x0) {
+		x0 = clip.x0;
 	}
-	if (y1 >= lcd_height) {
-		y1 = lcd_height - 1;
+	if (y0 < (uint16_t) clip.y0) {
+		y0 = clip.y0;
 	}
-
-	setArea(x0, y0, x1, y1);
-
-	drawStart();
-	size = (uint32_t) (1 + (x1 - x0)) * (uint32_t) (1 + (y1 - y0));
-	tmp = size / 8;
-	if (tmp != 0) {
-		for (i = tmp; i != 0; i--) {
-			draw(color); //1
-			draw(color); //2
-			draw(color); //3
-			draw(color); //4
-			draw(color); //5
-			draw(color); //6
-			draw(color); //7
-			draw(color); //8
-		}
-		for (i = size - tmp; i != 0; i--) {
-			draw(color);
-		}
-	} else {
-		for (i = size; i != 0; i--) {
-			draw(color);
-		}
+	if (x1 > (uint16_t) clip.x1) {
+		x1 = clip.x1;
+	}
+	if (y1 > (uint16_t) clip.y1) {
+		y1 = clip.y1;
+	}
+	if ((x0 > x1) || (y0 > y1)) //outside of clip window
+	{
+		return;
 	}
-	drawStop();
+
+	fill_area(x0, y0, x1, y1, COLOR_TO_RGB565(color));
 
 	return;
 }
 
-void MI0283QT2::drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t color) {
-	int16_t err, x, y;
+//midpoint circle, pixels of one octant step with the same x are sent as runs:
+//vertical runs in the columns x0+-x and horizontal runs in the rows y0+-x
+void MI0283QT2::drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, color_t color) {
+	PROFILE(LCD_PROFILE_CIRCLE);
+	int16_t err, x, y, y_start;
+	uint16_t rgb = COLOR_TO_RGB565(color);
 
 	err = -radius;
 	x = radius;
 	y = 0;
+	y_start = 0;
 
 	while (x >= y) {
-		drawPixel(x0 + x, y0 + y, color);
-		drawPixel(x0 - x, y0 + y, color);
-		drawPixel(x0 + x, y0 - y, color);
-		drawPixel(x0 - x, y0 - y, color);
-		drawPixel(x0 + y, y0 + x, color);
-		drawPixel(x0 - y, y0 + x, color);
-		drawPixel(x0 + y, y0 - x, color);
-		drawPixel(x0 - y, y0 - x, color);
-
 		err += y;
 		y++;
 		err += y;
-		if (err >= 0) {
-			x--;
-			err -= x;
-			err -= x;
+		if ((err >= 0) || (x < y)) //x changes or last step: draw run y_start...y-1
+		{
+			draw_vspan(x0 + x, y0 + y_start, y0 + y - 1, rgb);
+			draw_vspan(x0 - x, y0 + y_start, y0 + y - 1, rgb);
+			draw_vspan(x0 + x, y0 - y + 1, y0 - y_start, rgb);
+			draw_vspan(x0 - x, y0 - y + 1, y0 - y_start, rgb);
+			draw_hspan(x0 + y_start, x0 + y - 1, y0 + x, rgb);
+			draw_hspan(x0 - y + 1, x0 - y_start, y0 + x, rgb);
+			draw_hspan(x0 + y_start, x0 + y - 1, y0 - x, rgb);
+			draw_hspan(x0 - y + 1, x0 - y_start, y0 - x, rgb);
+			y_start = y;
+			if (err >= 0) {
+				x--;
+				err -= x;
+				err -= x;
+			}
 		}
 	}
 
 	return;
 }
 
-void MI0283QT2::fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t color) {
-	int16_t err, x, y;
+//midpoint circle, every row is filled once with its widest span
+void MI0283QT2::fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, color_t color) {
+	PROFILE(LCD_PROFILE_CIRCLE);
+	int16_t err, x, y, last_y;
+	uint16_t rgb = COLOR_TO_RGB565(color);
 
 	err = -radius;
 	x = radius;
 	y = 0;
 
 	while (x >= y) {
-		drawLine(x0 - x, y0 + y, x0 + x, y0 + y, color);
-		drawLine(x0 - x, y0 - y, x0 + x, y0 - y, color);
-		drawLine(x0 - y, y0 + x, x0 + y, y0 + x, color);
-		drawLine(x0 - y, y0 - x, x0 + y, y0 - x, color);
-
+		last_y = y;
 		err += y;
 		y++;
 		err += y;
-		if (err >= 0) {
+
+		draw_hspan(x0 - x, x0 + x, y0 + last_y, rgb);
+		if (last_y != 0) {
+			draw_hspan(x0 - x, x0 + x, y0 - last_y, rgb);
+		}
+
+		if (err >= 0) //x changes: rows y0+-x are complete
+		{
+			if (x != last_y) {
+				draw_hspan(x0 - last_y, x0 + last_y, y0 + x, rgb);
+				draw_hspan(x0 - last_y, x0 + last_y, y0 - x, rgb);
+			}
 			x--;
 			err -= x;
 			err -= x;
@@ -566,66 +893,326 @@ void MI0283QT2::fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t c
 	return;
 }
 
-uint16_t MI0283QT2::drawChar(uint16_t x, uint16_t y, char c, uint8_t size, uint16_t color, uint16_t bg_color) {
-	uint16_t ret;
-#if FONT_WIDTH <= 8
-	uint8_t data, mask;
-#elif FONT_WIDTH <= 16
-	uint16_t data, mask;
-#elif FONT_WIDTH <= 32
-	uint32_t data, mask;
-#endif
-	uint8_t i, j, width, height;
-	const prog_uint8_t *ptr;
+//thick line with round caps: every row is filled once from the leftmost to the rightmost crossing
+//of its border, the border is made of the two end circles and the two long sides of the band
+//(sides start at the ends moved by +-normal in 8.8 fixed point, crossings in 12.20 rounded inwards)
+void MI0283QT2::fillCapsule(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t radius, color_t color) {
+	int16_t dx, dy, y, y_end, x_min, x_max, x, d, h;
+	int32_t nx, ny, ax, ay, slope, n;
+	uint16_t len;
+	uint8_t i;
+	uint16_t rgb = COLOR_TO_RGB565(color);
 
-	i = (uint8_t) c;
-#if FONT_WIDTH <= 8
-	ptr = &font_PGM[(i - FONT_START) * (8 * FONT_HEIGHT / 8)];
-#elif FONT_WIDTH <= 16
-	ptr = &font_PGM[(i-FONT_START)*(16*FONT_HEIGHT/8)];
-#elif FONT_WIDTH <= 32
-	ptr = &font_PGM[(i-FONT_START)*(32*FONT_HEIGHT/8)];
-#endif
-	width = FONT_WIDTH;
-	height = FONT_HEIGHT;
+	if (radius == 0) {
+		drawLine(x0, y0, x1, y1, color);
+		return;
+	}
 
-	if (size <= 1) {
-		ret = x + width;
-		if ((ret - 1) >= lcd_width) {
-			return lcd_width + 1;
-		} else if ((y + height - 1) >= lcd_height) {
-			return lcd_width + 1;
+	PROFILE(LCD_PROFILE_LINE);
+	if (y0 > y1) //top to bottom
+	{
+		x = x0;
+		x0 = x1;
+		x1 = x;
+		y = y0;
+		y0 = y1;
+		y1 = y;
+	}
+	dx = x1 - x0;
+	dy = y1 - y0;
+
+	//normal of the band with length radius
+	nx = ny = 0;
+	slope = 0;
+	len = isqrt(((int32_t) dx * dx) + ((int32_t) dy * dy));
+	if (len != 0) {
+		n = (int32_t) dy * radius * 256;
+		nx = -((n + (len / 2)) / len);
+		n = (int32_t) dx * radius * 256;
+		ny = (n + ((n < 0) ? -(int32_t) (len / 2) : (int32_t) (len / 2))) / len;
+		if (dy != 0) {
+			slope = ((int32_t) dx * 4096) / dy; //both long sides are parallel
 		}
+	}
 
-		setArea(x, y, (x + width - 1), (y + height - 1));
+	y = y0 - radius;
+	if (y < clip.y0) {
+		y = clip.y0;
+	}
+	y_end = y1 + radius;
+	if (y_end > clip.y1) {
+		y_end = clip.y1;
+	}
 
-		drawStart();
-		for (; height != 0; height--) {
-#if FONT_WIDTH <= 8
-			data = pgm_read_byte(ptr);
-			ptr += 1;
-#elif FONT_WIDTH <= 16
-			data = pgm_read_word(ptr); ptr+=2;
-#elif FONT_WIDTH <= 32
-			data = pgm_read_dword(ptr); ptr+=4;
+	for (; y <= y_end; y++) {
+		x_min = 0x7FFF;
+		x_max = -0x7FFF;
+		//end circles
+		for (i = 0; i < 2; i++) {
+			d = y - ((i == 0) ? y0 : y1);
+			if ((d >= -radius) && (d <= radius)) {
+				h = isqrt(((int32_t) radius * radius) - ((int32_t) d * d));
+				x = (i == 0) ? x0 : x1;
+				if ((x - h) < x_min) {
+					x_min = x - h;
+				}
+				if ((x + h) > x_max) {
+					x_max = x + h;
+				}
+			}
+		}
+		//long sides: segment moved by +normal and -normal
+		for (i = 0; (i < 2) && (len != 0); i++) {
+			ax = ((int32_t) x0 * 256) + ((i == 0) ? nx : -nx);
+			ay = ((int32_t) y0 * 256) + ((i == 0) ? ny : -ny);
+			n = ((int32_t) y * 256) - ay; //row relative to the side start
+			if ((n < 0) || (n > ((int32_t) dy * 256))) {
+				continue;
+			}
+			if (dy == 0) //horizontal: whole side is in this row
+			{
+				x = (int16_t) ((ax + ((dx < 0) ? ((int32_t) dx * 256) : 0) + 0xFF) >> 8);
+				if (x < x_min) {
+					x_min = x;
+				}
+				x = (int16_t) ((ax + ((dx < 0) ? 0 : ((int32_t) dx * 256))) >> 8);
+				if (x > x_max) {
+					x_max = x;
+				}
+			} else { //the crossing is the left or the right border
+				n = (ax * 4096) + (n * slope);
+				x = (int16_t) ((n + 0xFFFFFL) >> 20);
+				if (x < x_min) {
+					x_min = x;
+				}
+				x = (int16_t) (n >> 20);
+				if (x > x_max) {
+					x_max = x;
+				}
+			}
+		}
+		draw_hspan(x_min, x_max, y, rgb);
+	}
+
+	return;
+}
+
+void MI0283QT2::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, color_t color) {
+	PROFILE(LCD_PROFILE_POLYGON);
+	LCD_POINT p[3];
+
+	p[0].x = x0;
+	p[0].y = y0;
+	p[1].x = x1;
+	p[1].y = y1;
+	p[2].x = x2;
+	p[2].y = y2;
+	fillPolygon(p, 3, color);
+
+	return;
+}
+
+//Even-odd scanline fill: every edge is walked in 16.16 fixed point from row to row and
+//each pair of crossings is filled from the leftmost to the rightmost x the edges reach in this row.
+void MI0283QT2::fillPolygon(const LCD_POINT *p, uint8_t count, color_t color) {
+	PROFILE(LCD_PROFILE_POLYGON);
+	struct {
+		int32_t x, dx; //x at the upper border of the next row, x step per row
+		int16_t y0, y1, x1; //first row, last row, x at last row
+		uint8_t bottom; //last row is a bottom vertex (the outline turns up): crossing in the last row too
+	} edge[LCD_POLYGON_MAX_POINTS];
+	struct {
+		int16_t min, max, mid;
+	} cross[LCD_POLYGON_MAX_POINTS], tmp;
+	uint8_t edges, n, i, j, a, b, k;
+	int16_t y, y_min, y_max, y_end, x_min, x_max;
+	int32_t top, bottom;
+	uint16_t rgb = COLOR_TO_RGB565(color);
+
+	if ((count == 0) || (count > LCD_POLYGON_MAX_POINTS)) {
+		return;
+	}
+
+	y_min = y_max = p[0].y;
+	x_min = x_max = p[0].x;
+	for (i = 1; i < count; i++) {
+		if (p[i].y < y_min) {
+			y_min = p[i].y;
+		}
+		if (p[i].y > y_max) {
+			y_max = p[i].y;
+		}
+		if (p[i].x < x_min) {
+			x_min = p[i].x;
+		}
+		if (p[i].x > x_max) {
+			x_max = p[i].x;
+		}
+	}
+
+	if ((y_max < clip.y0) || (y_min > clip.y1) || (x_max < clip.x0) || (x_min > clip.x1)) {
+		return;
+	}
+	if (y_min == y_max) //flat polygon
+	{
+		draw_hspan(x_min, x_max, y_min, rgb);
+		return;
+	}
+
+	y = (y_min < clip.y0) ? clip.y0 : y_min; //first visible row
+	y_end = (y_max > clip.y1) ? clip.y1 : y_max;
+
+	//edge list (top to bottom), horizontal edges are covered by their neighbours
+	for (i = 0, edges = 0; i < count; i++) {
+		a = i;
+		b = ((i + 1) < count) ? (i + 1) : 0;
+		if (p[a].y == p[b].y) {
+			continue;
+		}
+		if (p[a].y > p[b].y) {
+			n = a;
+			a = b;
+			b = n;
+		}
+		edge[edges].y0 = p[a].y;
+		edge[edges].y1 = p[b].y;
+		edge[edges].x1 = p[b].x;
+		//walk on from the bottom vertex away from this edge, over horizontal edges
+		for (j = 0, k = b; j < count; j++) {
+			n = (b != i) ? (((k + 1) < count) ? (k + 1) : 0) : ((k != 0) ? (k - 1) : (count - 1));
+			if (p[n].y != p[b].y) {
+				break;
+			}
+			k = n;
+		}
+		edge[edges].bottom = (p[n].y < p[b].y);
+		edge[edges].dx = ((int32_t) (p[b].x - p[a].x) << 16) / (p[b].y - p[a].y);
+		edge[edges].x = (int32_t) p[a].x << 16;
+		if (y > p[a].y) //starts above the screen
+		{
+			edge[edges].x += (edge[edges].dx * (y - p[a].y)) - (edge[edges].dx / 2);
+		}
+		edges++;
+	}
+
+	for (; y <= y_end; y++) {
+		//crossings of this row sorted by their x at the row center
+		for (i = 0, n = 0; i < edges; i++) {
+			if ((y < edge[i].y0) || (y > edge[i].y1) || ((y == edge[i].y1) && !edge[i].bottom)) {
+				continue;
+			}
+			top = edge[i].x;
+			if (y == edge[i].y1) {
+				bottom = (int32_t) edge[i].x1 << 16;
+			} else if (y == edge[i].y0) {
+				bottom = top + (edge[i].dx / 2);
+			} else {
+				bottom = top + edge[i].dx;
+			}
+			edge[i].x = bottom;
+
+			top = (top + 0x8000L) >> 16;
+			bottom = (bottom + 0x8000L) >> 16;
+			if (top < bottom) {
+				tmp.min = top;
+				tmp.max = bottom;
+			} else {
+				tmp.min = bottom;
+				tmp.max = top;
+			}
+			tmp.mid = (tmp.min + tmp.max) / 2;
+			for (j = n; (j != 0) && (cross[j - 1].mid > tmp.mid); j--) {
+				cross[j] = cross[j - 1];
+			}
+			cross[j] = tmp;
+			n++;
+		}
+
+		for (i = 1; i < n; i += 2) {
+			x_min = (cross[i - 1].min < cross[i].min) ? cross[i - 1].min : cross[i].min;
+			x_max = (cross[i - 1].max > cross[i].max) ? cross[i - 1].max : cross[i].max;
+			draw_hspan(x_min, x_max, y, rgb);
+		}
+	}
+
+	return;
+}
+
+uint16_t MI0283QT2::drawChar(uint16_t x, uint16_t y, char c, uint8_t size, color_t color, color_t bg_color) {
+	PROFILE(LCD_PROFILE_TEXT);
+	uint16_t ret;
+#if FONT_WIDTH <= 8
+	uint8_t data, mask;
+#elif FONT_WIDTH <= 16
+	uint16_t data, mask;
+#elif FONT_WIDTH <= 32
+	uint32_t data, mask;
+#endif
+	uint8_t i, j, width, height;
+	uint16_t fg = COLOR_TO_RGB565(color), bg = COLOR_TO_RGB565(bg_color);
+	const prog_uint8_t *ptr;
+
+	i = (uint8_t) c;
+#if FONT_WIDTH <= 8
+	ptr = &font_PGM[(i - FONT_START) * (8 * FONT_HEIGHT / 8)];
+#elif FONT_WIDTH <= 16
+	ptr = &font_PGM[(i-FONT_START)*(16*FONT_HEIGHT/8)];
+#elif FONT_WIDTH <= 32
+	ptr = &font_PGM[(i-FONT_START)*(32*FONT_HEIGHT/8)];
+#endif
+	width = FONT_WIDTH;
+	height = FONT_HEIGHT;
+
+	if (size <= 1) {
+		size = 1;
+	}
+	ret = x + (width * size);
+	if ((ret - 1) >= lcd_width) {
+		return lcd_width + 1;
+	} else if ((y + (height * size) - 1) >= lcd_height) {
+		return lcd_width + 1;
+	}
+
+	if (((int16_t) (ret - 1) < clip.x0) || ((int16_t) x > clip.x1) || ((int16_t) (y + (height * size) - 1) < clip.y0)
+			|| ((int16_t) y > clip.y1)) //outside of clip window
+			{
+		return ret;
+	}
+	if (bg_color == COLOR_TRANSPARENT) //background is not drawn
+	{
+		draw_char_transparent(x, y, ptr, size, fg);
+		return ret;
+	}
+	if (((int16_t) x < clip.x0) || ((int16_t) (ret - 1) > clip.x1) || ((int16_t) y < clip.y0)
+			|| ((int16_t) (y + (height * size) - 1) > clip.y1)) //partly inside of clip window
+			{
+		draw_char_clipped(x, y, ptr, size, fg, bg);
+		return ret;
+	}
+
+	if (size == 1) {
+		setArea(x, y, (x + width - 1), (y + height - 1));
+
+		drawStart();
+		for (; height != 0; height--) {
+#if FONT_WIDTH <= 8
+			data = pgm_read_byte(ptr);
+			ptr += 1;
+#elif FONT_WIDTH <= 16
+			data = pgm_read_word(ptr); ptr+=2;
+#elif FONT_WIDTH <= 32
+			data = pgm_read_dword(ptr); ptr+=4;
 #endif
 			for (mask = (1 << (width - 1)); mask != 0; mask >>= 1) {
 				if (data & mask) {
-					draw(color);
+					draw(fg);
 				} else {
-					draw(bg_color);
+					draw(bg);
 				}
 			}
 		}
 		drawStop();
 	} else {
-		ret = x + (width * size);
-		if ((ret - 1) >= lcd_width) {
-			return lcd_width + 1;
-		} else if ((y + (height * size) - 1) >= lcd_height) {
-			return lcd_width + 1;
-		}
-
 		setArea(x, y, (x + (width * size) - 1), (y + (height * size) - 1));
 
 		drawStart();
@@ -642,11 +1229,11 @@ uint16_t MI0283QT2::drawChar(uint16_t x, uint16_t y, char c, uint8_t size, uint1
 				for (mask = (1 << (width - 1)); mask != 0; mask >>= 1) {
 					if (data & mask) {
 						for (j = size; j != 0; j--) {
-							draw(color);
+							draw(fg);
 						}
 					} else {
 						for (j = size; j != 0; j--) {
-							draw(bg_color);
+							draw(bg);
 						}
 					}
 				}
@@ -658,7 +1245,8 @@ uint16_t MI0283QT2::drawChar(uint16_t x, uint16_t y, char c, uint8_t size, uint1
 	return ret;
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, char *s, uint8_t size, uint16_t color, uint16_t bg_color) {
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, char *s, uint8_t size, color_t color, color_t bg_color) {
+	PROFILE(LCD_PROFILE_TEXT);
 	while (*s != 0) {
 		x = drawChar(x, y, (char) *s++, size, color, bg_color);
 		if (x > lcd_width) {
@@ -669,39 +1257,23 @@ uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, char *s, uint8_t size, uint
 	return x;
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, int i, uint8_t size, uint16_t color, uint16_t bg_color) {
-	char tmp[16];
-
-	itoa(i, tmp, 10);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, int i, uint8_t size, color_t color, color_t bg_color) {
+	return drawInteger(x, y, i, DEC, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, unsigned int i, uint8_t size, uint16_t color, uint16_t bg_color) {
-	char tmp[16];
-
-	utoa(i, tmp, 10);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, unsigned int i, uint8_t size, color_t color, color_t bg_color) {
+	return drawInteger(x, y, i, DEC, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, long l, uint8_t size, uint16_t color, uint16_t bg_color) {
-	char tmp[32];
-
-	ltoa(l, tmp, 10);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, long l, uint8_t size, color_t color, color_t bg_color) {
+	return drawInteger(x, y, l, DEC, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, unsigned long l, uint8_t size, uint16_t color, uint16_t bg_color) {
-	char tmp[32];
-
-	ultoa(l, tmp, 10);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, unsigned long l, uint8_t size, color_t color, color_t bg_color) {
+	return drawInteger(x, y, l, DEC, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, String &s, uint8_t size, uint16_t color, uint16_t bg_color) {
+uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, String &s, uint8_t size, color_t color, color_t bg_color) {
 	uint16_t i;
 
 	for (i = 0; i < s.length(); i++) {
@@ -714,7 +1286,8 @@ uint16_t MI0283QT2::drawText(uint16_t x, uint16_t y, String &s, uint8_t size, ui
 	return x;
 }
 
-uint16_t MI0283QT2::drawTextPGM(uint16_t x, uint16_t y, PGM_P s, uint8_t size, uint16_t color, uint16_t bg_color) {
+uint16_t MI0283QT2::drawTextPGM(uint16_t x, uint16_t y, PGM_P s, uint8_t size, color_t color, color_t bg_color) {
+	PROFILE(LCD_PROFILE_TEXT);
 	char c;
 
 	c = pgm_read_byte(s++);
@@ -730,234 +1303,71 @@ uint16_t MI0283QT2::drawTextPGM(uint16_t x, uint16_t y, PGM_P s, uint8_t size, u
 }
 
 uint16_t MI0283QT2::drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, char *s, uint8_t size,
-		uint16_t color, uint16_t bg_color) {
-	uint16_t x = x0, y = y0, wlen, llen;
-	char c;
-	char *wstart;
-
-	fillRect(x0, y0, x1, y1, bg_color);
-
-	llen = (x1 - x0) / (FONT_WIDTH * size); //line len in chars
-	wstart = s;
-	while (*s && (y < y1)) {
-		c = *s++;
-		if (c == '\n') //new line
-				{
-			x = x0;
-			y += (FONT_HEIGHT * size) + 1;
-			continue;
-		} else if (c == '\r') //skip
-				{
-			continue;
-		}
-
-		if (c == ' ') //start of a new word
-				{
-			wstart = s;
-			if (x == x0) //do nothing
-					{
-				continue;
-			}
-		}
-
-		if (c) {
-			if ((x + (FONT_WIDTH * size)) > x1) //new line
-					{
-				if (c == ' ') //do not start with space
-						{
-					x = x0;
-					y += (FONT_HEIGHT * size) + 1;
-				} else {
-					wlen = (s - wstart);
-					if (wlen > llen) //word too long
-							{
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						if (y < y1) {
-							x = drawChar(x, y, c, size, color, bg_color);
-						}
-					} else {
-						fillRect(x - (wlen * FONT_WIDTH * size), y, x1, (y + (FONT_HEIGHT * size)), bg_color); //clear word
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						s = wstart;
-					}
-				}
-			} else {
-				x = drawChar(x, y, c, size, color, bg_color);
-			}
-		}
-	}
-
-	return x;
+		color_t color, color_t bg_color) {
+	return draw_ml_text(x0, y0, x1, y1, s, 0, size, color, bg_color);
 }
 
 uint16_t MI0283QT2::drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, String &s, uint8_t size,
-		uint16_t color, uint16_t bg_color) {
-	uint16_t x = x0, y = y0, wstart, wlen, llen, p;
-	char c;
-
-	fillRect(x0, y0, x1, y1, bg_color);
-
-	llen = (x1 - x0) / (FONT_WIDTH * size); //line len in chars
-	wstart = 0;
-	for (p = 0; (p < s.length()) && (y < y1); p++) {
-		c = (char) s[p];
-		if (c == '\n') //new line
-				{
-			x = x0;
-			y += (FONT_HEIGHT * size) + 1;
-			continue;
-		} else if (c == '\r') //skip
-				{
-			continue;
-		}
-
-		if (c == ' ') //start of a new word
-				{
-			wstart = p;
-			if (x == x0) //do nothing
-					{
-				continue;
-			}
-		}
-
-		if (c) {
-			if ((x + (FONT_WIDTH * size)) > x1) //new line
-					{
-				if (c == ' ') //do not start with space
-						{
-					x = x0;
-					y += (FONT_HEIGHT * size) + 1;
-				} else {
-					wlen = (p - wstart);
-					if (wlen > llen) //word too long
-							{
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						if (y < y1) {
-							x = drawChar(x, y, c, size, color, bg_color);
-						}
-					} else {
-						fillRect(x - (wlen * FONT_WIDTH * size), y, x1, (y + (FONT_HEIGHT * size)), bg_color); //clear word
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						p = wstart;
-					}
-				}
-			} else {
-				x = drawChar(x, y, c, size, color, bg_color);
-			}
-		}
-	}
-
-	return x;
+		color_t color, color_t bg_color) {
+	return draw_ml_text(x0, y0, x1, y1, s.c_str(), 0, size, color, bg_color);
 }
 
 uint16_t MI0283QT2::drawMLTextPGM(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, PGM_P s, uint8_t size,
-		uint16_t color, uint16_t bg_color) {
-	uint16_t x = x0, y = y0, wlen, llen;
-	char c;
-	PGM_P wstart;
-
-	fillRect(x0, y0, x1, y1, bg_color);
-
-	llen = (x1 - x0) / (FONT_WIDTH * size); //line len in chars
-	wstart = s;
-	c = pgm_read_byte(s++);
-	while ((c != 0) && (y < y1)) {
-		if (c == '\n') //new line
-				{
-			x = x0;
-			y += (FONT_HEIGHT * size) + 1;
-			c = pgm_read_byte(s++);
-			continue;
-		} else if (c == '\r') //skip
-				{
-			c = pgm_read_byte(s++);
-			continue;
-		}
-
-		if (c == ' ') //start of a new word
-				{
-			wstart = s;
-			if (x == x0) //do nothing
-					{
-				c = pgm_read_byte(s++);
-				continue;
-			}
-		}
-
-		if (c) {
-			if ((x + (FONT_WIDTH * size)) > x1) //new line
-					{
-				if (c == ' ') //do not start with space
-						{
-					x = x0;
-					y += (FONT_HEIGHT * size) + 1;
-				} else {
-					wlen = (s - wstart);
-					if (wlen > llen) //word too long
-							{
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						if (y < y1) {
-							x = drawChar(x, y, c, size, color, bg_color);
-						}
-					} else {
-						fillRect(x - (wlen * FONT_WIDTH * size), y, x1, (y + (FONT_HEIGHT * size)), bg_color); //clear word
-						x = x0;
-						y += (FONT_HEIGHT * size) + 1;
-						s = wstart;
-					}
-				}
-			} else {
-				x = drawChar(x, y, c, size, color, bg_color);
-			}
-		}
-		c = pgm_read_byte(s++);
-	}
-
-	return x;
+		color_t color, color_t bg_color) {
+	return draw_ml_text(x0, y0, x1, y1, s, 1, size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, char val, uint8_t base, uint8_t size, uint16_t color,
-		uint16_t bg_color) {
-	char tmp[16 + 1];
-
-	itoa((int) val, tmp, base);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, char val, uint8_t base, uint8_t size, color_t color,
+		color_t bg_color) {
+	return drawInteger(x, y, (int) val, base, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, unsigned char val, uint8_t base, uint8_t size, uint16_t color,
-		uint16_t bg_color) {
-	char tmp[16 + 1];
-
-	itoa((int) val, tmp, base);
-
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, unsigned char val, uint8_t base, uint8_t size, color_t color,
+		color_t bg_color) {
+	return drawInteger(x, y, (unsigned int) val, base, 0, ' ', size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t size, uint16_t color,
-		uint16_t bg_color) {
-	char tmp[16 + 1];
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t size, color_t color,
+		color_t bg_color) {
+	return drawInteger(x, y, val, base, 0, ' ', size, color, bg_color);
+}
 
-	itoa(val, tmp, base);
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t size, color_t color,
+		color_t bg_color) {
+	return drawInteger(x, y, val, base, 0, ' ', size, color, bg_color);
+}
 
-	return drawText(x, y, tmp, size, color, bg_color);
+//negative values have a sign only for base DEC, other bases show the two's complement (like itoa)
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t width, char pad, uint8_t size,
+		color_t color, color_t bg_color) {
+	if ((val < 0) && (base == DEC)) {
+		return draw_number(x, y, -((long) val), 1, base, width, pad, size, color, bg_color);
+	}
+	return draw_number(x, y, (unsigned int) val, 0, base, width, pad, size, color, bg_color);
 }
 
-uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t size, uint16_t color,
-		uint16_t bg_color) {
-	char tmp[32 + 1];
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, unsigned int val, uint8_t base, uint8_t width, char pad,
+		uint8_t size, color_t color, color_t bg_color) {
+	return draw_number(x, y, val, 0, base, width, pad, size, color, bg_color);
+}
 
-	ltoa(val, tmp, base);
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t width, char pad, uint8_t size,
+		color_t color, color_t bg_color) {
+	if ((val < 0) && (base == DEC)) {
+		return draw_number(x, y, -((unsigned long) val), 1, base, width, pad, size, color, bg_color);
+	}
+	return draw_number(x, y, (unsigned long) val, 0, base, width, pad, size, color, bg_color);
+}
 
-	return drawText(x, y, tmp, size, color, bg_color);
+uint16_t MI0283QT2::drawInteger(uint16_t x, uint16_t y, unsigned long val, uint8_t base, uint8_t width, char pad,
+		uint8_t size, color_t color, color_t bg_color) {
+	return draw_number(x, y, val, 0, base, width, pad, size, color, bg_color);
 }
 
-void MI0283QT2::printOptions(uint8_t size, uint16_t color, uint16_t bg_color) {
+void MI0283QT2::printOptions(uint8_t size, color_t color, color_t bg_color) {
+#if defined(PRINT_BUFFERED)
+	flush();
+#endif
 	p_size = size;
 	p_fg = color;
 	p_bg = bg_color;
@@ -966,6 +1376,9 @@ void MI0283QT2::printOptions(uint8_t size, uint16_t color, uint16_t bg_color) {
 }
 
 void MI0283QT2::printClear(void) {
+#if defined(PRINT_BUFFERED)
+	p_len = 0;
+#endif
 	clear(p_bg);
 
 	p_x = PRINT_STARTX;
@@ -975,6 +1388,9 @@ void MI0283QT2::printClear(void) {
 }
 
 void MI0283QT2::printXY(uint16_t x, uint16_t y) {
+#if defined(PRINT_BUFFERED)
+	flush();
+#endif
 	p_x = x;
 	p_y = y;
 
@@ -982,6 +1398,9 @@ void MI0283QT2::printXY(uint16_t x, uint16_t y) {
 }
 
 uint16_t MI0283QT2::printGetX(void) {
+#if defined(PRINT_BUFFERED)
+	flush();
+#endif
 	return p_x;
 }
 
@@ -990,7 +1409,17 @@ uint16_t MI0283QT2::printGetY(void) {
 }
 
 void MI0283QT2::printPGM(PGM_P s) {
+#if defined(PRINT_BUFFERED)
+	char c;
+
+	c = pgm_read_byte(s++);
+	while (c != 0) {
+		write((uint8_t) c);
+		c = pgm_read_byte(s++);
+	}
+#else
 	uint16_t x = p_x, y = p_y, x_last;
+	uint8_t size = (p_size <= 1) ? 1 : p_size; //as drawChar() and the buffered print
 	char c;
 
 	c = pgm_read_byte(s++);
@@ -998,8 +1427,8 @@ void MI0283QT2::printPGM(PGM_P s) {
 		if (c == '\n') //new line
 				{
 			x = PRINT_STARTX;
-			y += (FONT_HEIGHT * p_size) + 1;
-			if (y >= lcd_height) {
+			y += (FONT_HEIGHT * size) + 1;
+			if ((y + (FONT_HEIGHT * size)) > lcd_height) {
 				y = PRINT_STARTY;
 			}
 		} else if (c == '\r') //skip
@@ -1007,15 +1436,17 @@ void MI0283QT2::printPGM(PGM_P s) {
 			//do nothing
 		} else {
 			x_last = x;
-			x = drawChar(x, y, c, p_size, p_fg, p_bg);
+			x = drawChar(x, y, c, size, p_fg, p_bg);
 			if (x > lcd_width) {
-				fillRect(x_last, y, lcd_width - 1, y + (FONT_HEIGHT * p_size), p_bg);
+				if (p_bg != COLOR_TRANSPARENT) {
+					fillRect(x_last, y, lcd_width - 1, y + (FONT_HEIGHT * size) - 1, p_bg);
+				}
 				x = PRINT_STARTX;
-				y += (FONT_HEIGHT * p_size) + 1;
-				if (y >= lcd_height) {
+				y += (FONT_HEIGHT * size) + 1;
+				if ((y + (FONT_HEIGHT * size)) > lcd_height) {
 					y = PRINT_STARTY;
 				}
-				x = drawChar(x, y, c, p_size, p_fg, p_bg);
+				x = drawChar(x, y, c, size, p_fg, p_bg);
 			}
 		}
 		c = pgm_read_byte(s++);
@@ -1023,32 +1454,69 @@ void MI0283QT2::printPGM(PGM_P s) {
 
 	p_x = x;
 	p_y = y;
+#endif
 
 	return;
 }
 
+#if defined(PRINT_BUFFERED)
+//characters are collected and drawn line by line, see flush()
+size_t MI0283QT2::write(uint8_t c) {
+	PROFILE(LCD_PROFILE_TEXT);
+	uint8_t size = (p_size <= 1) ? 1 : p_size;
+
+	if (c == '\n') {
+		print_line(1);
+	} else if (c == '\r') //skip
+			{
+		//do nothing
+	} else {
+		if ((p_x + ((p_len + 1) * FONT_WIDTH * size)) > lcd_width) //line full
+		{
+			print_line(1);
+		} else if (p_len >= PRINT_BUFFER_SIZE) {
+			print_line(0);
+		}
+		p_buf[p_len++] = c;
+	}
+
+	return 1;
+}
+
+//draws the buffered characters, the line is continued with the next write()
+void MI0283QT2::flush(void) {
+	PROFILE(LCD_PROFILE_TEXT);
+	print_line(0);
+
+	return;
+}
+#else
 size_t MI0283QT2::write(uint8_t c) {
+	PROFILE(LCD_PROFILE_TEXT);
 	uint16_t x = p_x, y = p_y;
+	uint8_t size = (p_size <= 1) ? 1 : p_size; //as drawChar() and the buffered print
 
 	if (c == '\n') {
 		x = PRINT_STARTX;
-		y += (FONT_HEIGHT * p_size) + 1;
-		if (y >= lcd_height) {
+		y += (FONT_HEIGHT * size) + 1;
+		if ((y + (FONT_HEIGHT * size)) > lcd_height) {
 			y = PRINT_STARTY;
 		}
 	} else if (c == '\r') //skip
 			{
 		//do nothing
 	} else {
-		x = drawChar(x, y, c, p_size, p_fg, p_bg);
+		x = drawChar(x, y, c, size, p_fg, p_bg);
 		if (x > lcd_width) {
-			fillRect(p_x, y, lcd_width - 1, y + (FONT_HEIGHT * p_size), p_bg);
+			if (p_bg != COLOR_TRANSPARENT) {
+				fillRect(p_x, y, lcd_width - 1, y + (FONT_HEIGHT * size) - 1, p_bg);
+			}
 			x = PRINT_STARTX;
-			y += (FONT_HEIGHT * p_size) + 1;
-			if (y >= lcd_height) {
+			y += (FONT_HEIGHT * size) + 1;
+			if ((y + (FONT_HEIGHT * size)) > lcd_height) {
 				y = PRINT_STARTY;
 			}
-			x = drawChar(x, y, c, p_size, p_fg, p_bg);
+			x = drawChar(x, y, c, size, p_fg, p_bg);
 		}
 	}
 
@@ -1057,6 +1525,7 @@ size_t MI0283QT2::write(uint8_t c) {
 
 	return 1;
 }
+#endif
 
 size_t MI0283QT2::write(const char *s) {
 	size_t len = 0;
@@ -1083,79 +1552,463 @@ size_t MI0283QT2::write(const uint8_t *s, size_t size) {
 
 //-------------------- Private --------------------
 
-void MI0283QT2::reset(void) {
-	//SPI speed-down
-#if !defined(SOFTWARE_SPI)
-	uint8_t spcr, spsr;
-	spcr = SPCR;
-	SPCR = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
-	spsr = SPSR;
-	SPSR = (1 << SPI2X); //clk*2 -> clk=Fcpu/8
+uint8_t MI0283QT2::clip_contains(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+	return ((clip.x0 <= (int16_t) x0) && (clip.y0 <= (int16_t) y0) && (clip.x1 >= (int16_t) x1)
+			&& (clip.y1 >= (int16_t) y1));
+}
+
+#if defined(PRINT_BUFFERED)
+//Draws the buffered characters as one text run at the print position. At the end of a line (eol != 0)
+//the run is padded to the right edge, so the rest of the line is cleared only once.
+void MI0283QT2::print_line(uint8_t eol) {
+	uint16_t x1, x_end;
+	uint8_t size = (p_size <= 1) ? 1 : p_size;
+
+	x_end = p_x + (p_len * FONT_WIDTH * size);
+	x1 = eol ? (lcd_width - 1) : (x_end - 1);
+
+	if ((p_x <= x1) && ((p_y + (FONT_HEIGHT * size)) <= lcd_height)) {
+		if ((p_bg != COLOR_TRANSPARENT) && clip_contains(p_x, p_y, x1, p_y + (FONT_HEIGHT * size) - 1)) {
+			draw_text_run(p_x, p_y, x1, FONT_HEIGHT * size, p_buf, p_len, 0, size, COLOR_TO_RGB565(p_fg),
+					COLOR_TO_RGB565(p_bg));
+		} else {
+			draw_text_chars(p_x, p_y, p_buf, p_len, 0, size, p_fg, p_bg);
+			if (eol && (p_bg != COLOR_TRANSPARENT) && (x_end <= x1)) {
+				fillRect(x_end, p_y, x1, p_y + (FONT_HEIGHT * size) - 1, p_bg);
+			}
+		}
+	}
+	p_len = 0;
+	p_x = x_end;
+
+	if (eol) //new line, start at the top if the next one does not fit
+	{
+		p_x = PRINT_STARTX;
+		p_y += (FONT_HEIGHT * size) + 1;
+		if ((p_y + (FONT_HEIGHT * size)) > lcd_height) {
+			p_y = PRINT_STARTY;
+		}
+	}
+
+	return;
+}
 #endif
 
-	//reset
-	CS_DISABLE();
-	RST_ENABLE();
-	delay_10ms(5);
-	RST_DISABLE();
-	delay_10ms(5);
+void MI0283QT2::fill_area(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t rgb) {
+	setArea(x0, y0, x1, y1);
+	draw_repeat(rgb, (uint32_t) (1 + (x1 - x0)) * (uint32_t) (1 + (y1 - y0)));
 
-	//driving ability
-	wr_cmd(0xEA, 0x0000);
-	wr_cmd(0xEB, 0x0020);
-	wr_cmd(0xEC, 0x000C);
-	wr_cmd(0xED, 0x00C4);
-	wr_cmd(0xE8, 0x0040);
-	wr_cmd(0xE9, 0x0038);
-	wr_cmd(0xF1, 0x0001);
-	wr_cmd(0xF2, 0x0010);
-	wr_cmd(0x27, 0x00A3);
+	return;
+}
 
-	//power voltage
-	wr_cmd(0x1B, 0x001B);
-	wr_cmd(0x1A, 0x0001);
-	wr_cmd(0x24, 0x002F);
-	wr_cmd(0x25, 0x0057);
+//size pixels into the area of the last setArea(), the address wraps inside the area
+void MI0283QT2::draw_repeat(uint16_t rgb, uint32_t size) {
+#if !defined(SOFTWARE_SPI) || defined(LCD_USART_SPI)
+	uint16_t i;
+#endif
 
-	//VCOM offset
-	wr_cmd(0x23, 0x008D); //for flicker adjust
+	drawStart();
+#if defined(SOFTWARE_SPI) && !defined(LCD_USART_SPI)
+	SPIBus::writeRepeat(rgb, size); //precomputed port values
+	PROFILE_PIXELS(size);
+	PROFILE_BYTES(size * 2);
+#else
+	for (i = (size / 8); i != 0; i--) {
+		draw(rgb); //1
+		draw(rgb); //2
+		draw(rgb); //3
+		draw(rgb); //4
+		draw(rgb); //5
+		draw(rgb); //6
+		draw(rgb); //7
+		draw(rgb); //8
+	}
+	for (i = (size & 7); i != 0; i--) {
+		draw(rgb);
+	}
+#endif
+	drawStop();
 
-	//power on
-	wr_cmd(0x18, 0x0036);
-	wr_cmd(0x19, 0x0001); //start osc
-	wr_cmd(0x01, 0x0000); //wakeup
-	wr_cmd(0x1F, 0x0088);
-	_delay_ms(5);
-	wr_cmd(0x1F, 0x0080);
-	_delay_ms(5);
-	wr_cmd(0x1F, 0x0090);
-	_delay_ms(5);
-	wr_cmd(0x1F, 0x00D0);
-	_delay_ms(5);
+	return;
+}
 
-	//color selection
-	wr_cmd(0x17, 0x0005); //0x0005=65k, 0x0006=262k
+void MI0283QT2::draw_hspan(int16_t x0, int16_t x1, int16_t y, uint16_t rgb) {
+	if ((y < clip.y0) || (y > clip.y1)) {
+		return;
+	}
+	if (x0 < clip.x0) {
+		x0 = clip.x0;
+	}
+	if (x1 > clip.x1) {
+		x1 = clip.x1;
+	}
+	if (x0 > x1) {
+		return;
+	}
 
-	//panel characteristic
-	wr_cmd(0x36, 0x0000);
+	fill_area(x0, y, x1, y, rgb);
 
-	//display on
-	wr_cmd(0x28, 0x0038);
-	delay_10ms(4);
-	wr_cmd(0x28, 0x003C);
+	return;
+}
+
+void MI0283QT2::draw_vspan(int16_t x, int16_t y0, int16_t y1, uint16_t rgb) {
+	if ((x < clip.x0) || (x > clip.x1)) {
+		return;
+	}
+	if (y0 < clip.y0) {
+		y0 = clip.y0;
+	}
+	if (y1 > clip.y1) {
+		y1 = clip.y1;
+	}
+	if (y0 > y1) {
+		return;
+	}
+
+	fill_area(x, y0, x, y1, rgb);
+
+	return;
+}
+
+//glyph cell is partly inside of the clip window: send only the visible pixels
+void MI0283QT2::draw_char_clipped(uint16_t x, uint16_t y, const prog_uint8_t *ptr, uint8_t size, uint16_t fg, uint16_t bg) {
+#if FONT_WIDTH <= 8
+	uint8_t data;
+#elif FONT_WIDTH <= 16
+	uint16_t data;
+#elif FONT_WIDTH <= 32
+	uint32_t data;
+#endif
+	int16_t x0, y0, x1, y1, cx, cy;
+
+	x0 = ((int16_t) x < clip.x0) ? clip.x0 : x;
+	y0 = ((int16_t) y < clip.y0) ? clip.y0 : y;
+	x1 = x + (FONT_WIDTH * size) - 1;
+	if (x1 > clip.x1) {
+		x1 = clip.x1;
+	}
+	y1 = y + (FONT_HEIGHT * size) - 1;
+	if (y1 > clip.y1) {
+		y1 = clip.y1;
+	}
+	if ((x0 > x1) || (y0 > y1)) {
+		return;
+	}
+
+	setArea(x0, y0, x1, y1);
+
+	drawStart();
+	for (cy = (y0 - y); cy <= (y1 - (int16_t) y); cy++) {
+#if FONT_WIDTH <= 8
+		data = pgm_read_byte(ptr + (cy / size));
+#elif FONT_WIDTH <= 16
+		data = pgm_read_word(ptr + ((cy / size) * 2));
+#elif FONT_WIDTH <= 32
+		data = pgm_read_dword(ptr + ((cy / size) * 4));
+#endif
+		for (cx = (x0 - x); cx <= (x1 - (int16_t) x); cx++) {
+			if (data & (((glyph_line_t) 1 << (FONT_WIDTH - 1)) >> (cx / size))) {
+				draw(fg);
+			} else {
+				draw(bg);
+			}
+		}
+	}
+	drawStop();
+
+	return;
+}
+
+void MI0283QT2::fill_clipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t rgb) {
+	if (x0 < clip.x0) {
+		x0 = clip.x0;
+	}
+	if (y0 < clip.y0) {
+		y0 = clip.y0;
+	}
+	if (x1 > clip.x1) {
+		x1 = clip.x1;
+	}
+	if (y1 > clip.y1) {
+		y1 = clip.y1;
+	}
+	if ((x0 > x1) || (y0 > y1)) {
+		return;
+	}
+
+	fill_area(x0, y0, x1, y1, rgb);
+
+	return;
+}
 
-	//display options
-	setOrientation(0);
+//Sends only the foreground of a glyph, one window per run. The glyph is walked either in rows
+//or in columns, identical neighbour lines are merged. The direction with less windows is taken,
+//because every window costs a setArea() while the pixel data is the same for both.
+void MI0283QT2::draw_char_transparent(uint16_t x, uint16_t y, const prog_uint8_t *ptr, uint8_t size, uint16_t rgb) {
+	glyph_line_t rows[FONT_HEIGHT], cols[FONT_WIDTH], data;
+	uint8_t i, j;
 
-	//restore SPI settings
-#if !defined(SOFTWARE_SPI)
-	SPCR = spcr;
-	SPSR = spsr;
+	for (j = 0; j < FONT_WIDTH; j++) {
+		cols[j] = 0;
+	}
+	for (i = 0; i < FONT_HEIGHT; i++) {
+#if FONT_WIDTH <= 8
+		data = pgm_read_byte(ptr);
+		ptr += 1;
+#elif FONT_WIDTH <= 16
+		data = pgm_read_word(ptr); ptr+=2;
+#elif FONT_WIDTH <= 32
+		data = pgm_read_dword(ptr); ptr+=4;
 #endif
+		rows[i] = data;
+		for (j = 0; j < FONT_WIDTH; j++) {
+			if (data & ((glyph_line_t) 1 << (FONT_WIDTH - 1 - j))) {
+				cols[j] |= (glyph_line_t) 1 << (FONT_HEIGHT - 1 - i);
+			}
+		}
+	}
+
+	i = glyph_runs(x, y, rows, FONT_HEIGHT, FONT_WIDTH, size, 0, 0, rgb);
+	j = glyph_runs(x, y, cols, FONT_WIDTH, FONT_HEIGHT, size, 1, 0, rgb);
+	if (i <= j) {
+		glyph_runs(x, y, rows, FONT_HEIGHT, FONT_WIDTH, size, 0, 1, rgb);
+	} else {
+		glyph_runs(x, y, cols, FONT_WIDTH, FONT_HEIGHT, size, 1, 1, rgb);
+	}
+
+	return;
+}
+
+//counts (and draws if draw != 0) the runs of set bits, lines are rows (vertical = 0) or columns (vertical = 1)
+uint8_t MI0283QT2::glyph_runs(uint16_t x, uint16_t y, const glyph_line_t *lines, uint8_t count, uint8_t bits,
+		uint8_t size, uint8_t vertical, uint8_t draw, uint16_t rgb) {
+	glyph_line_t data, mask;
+	uint8_t i, j, k, start, runs = 0;
+
+	for (i = 0; i < count; i = j) {
+		data = lines[i];
+		for (j = i + 1; (j < count) && (lines[j] == data); j++) {
+			//identical lines are drawn as one
+		}
+		mask = (glyph_line_t) 1 << (bits - 1);
+		for (k = 0; k < bits;) {
+			if (!(data & (mask >> k))) {
+				k++;
+				continue;
+			}
+			start = k;
+			while ((k < bits) && (data & (mask >> k))) {
+				k++;
+			}
+			runs++;
+			if (!draw) {
+				continue;
+			}
+			if (vertical) {
+				fill_clipped(x + (i * size), y + (start * size), x + (j * size) - 1, y + (k * size) - 1, rgb);
+			} else {
+				fill_clipped(x + (start * size), y + (i * size), x + (k * size) - 1, y + (j * size) - 1, rgb);
+			}
+		}
+	}
+
+	return runs;
+}
+
+//Text box: every line is measured first and then drawn once, opaque lines as one text run padded
+//to the right edge. Lines not fitting completely are omitted, the box area below the last line
+//is cleared at the end.
+uint16_t MI0283QT2::draw_ml_text(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const char *s, uint8_t pgm,
+		uint8_t size, color_t color, color_t bg_color) {
+	PROFILE(LCD_PROFILE_TEXT);
+	uint16_t x = x0, y = y0, rows;
+	uint8_t llen, len, chars, clip_full;
+	const char *next;
+
+	if (size == 0) {
+		size = 1;
+	}
+	if ((x1 < x0) || (y1 < y0)) {
+		return x0;
+	}
+	clip_full = pushClip(x0, y0, x1, y1);
+
+	llen = (x1 - x0) / (FONT_WIDTH * size); //line len in chars
+	while (text_char(s, pgm) && ((y + (FONT_HEIGHT * size) - 1) <= y1)) //only complete lines
+	{
+		while (text_char(s, pgm) == ' ') //do not start with space
+		{
+			s++;
+		}
+		len = text_layout(s, pgm, llen, &chars, &next);
+		rows = (FONT_HEIGHT * size) + 1; //line with gap
+		if ((y + rows - 1) > y1) {
+			rows = y1 - y + 1;
+		}
+		x = x0 + (chars * FONT_WIDTH * size);
+
+		if (bg_color == COLOR_TRANSPARENT) //background is not drawn
+		{
+			draw_text_chars(x0, y, s, len, pgm, size, color, bg_color);
+		} else if (clip_contains(x0, y, x1, y + rows - 1)) {
+			draw_text_run(x0, y, x1, rows, s, len, pgm, size, COLOR_TO_RGB565(color), COLOR_TO_RGB565(bg_color));
+		} else { //box is clipped: characters and padding separately
+			draw_text_chars(x0, y, s, len, pgm, size, color, bg_color);
+			if (x <= x1) {
+				fillRect(x, y, x1, y + rows - 1, bg_color);
+			}
+			if ((x > x0) && (rows > (FONT_HEIGHT * size))) {
+				fillRect(x0, y + (FONT_HEIGHT * size), x - 1, y + rows - 1, bg_color);
+			}
+		}
+
+		y += (FONT_HEIGHT * size) + 1;
+		s = next;
+	}
+
+	if ((y <= y1) && (bg_color != COLOR_TRANSPARENT)) {
+		fillRect(x0, y, x1, y1, bg_color);
+	}
+
+	if (!clip_full) {
+		popClip();
+	}
+
+	return x;
+}
+
+//Draws one line of text in one window: the glyph rows are streamed character by character
+//and the window right of and below the text is filled with bg.
+void MI0283QT2::draw_text_run(uint16_t x0, uint16_t y, uint16_t x1, uint16_t rows, const char *s, uint8_t len,
+		uint8_t pgm, uint8_t size, uint16_t fg, uint16_t bg) {
+	glyph_line_t data, mask;
+	uint16_t r, pad;
+	uint8_t i, j, row;
+	char c;
+
+	setArea(x0, y, x1, y + rows - 1);
+
+	drawStart();
+	for (r = 0; r < rows; r++) {
+		pad = x1 - x0 + 1;
+		if (r < (FONT_HEIGHT * size)) {
+			row = r / size;
+			for (i = 0; i < len; i++) {
+				c = text_char(s + i, pgm);
+				if (c == '\r') {
+					continue;
+				}
+				data = glyph_row(c, row);
+				for (mask = ((glyph_line_t) 1 << (FONT_WIDTH - 1)); mask != 0; mask >>= 1) {
+					if (data & mask) {
+						for (j = size; j != 0; j--) {
+							draw(fg);
+						}
+					} else {
+						for (j = size; j != 0; j--) {
+							draw(bg);
+						}
+					}
+				}
+				pad -= FONT_WIDTH * size;
+			}
+		}
+		for (; pad != 0; pad--) {
+			draw(bg);
+		}
+	}
+	drawStop();
 
 	return;
 }
 
+uint16_t MI0283QT2::draw_text_chars(uint16_t x, uint16_t y, const char *s, uint8_t len, uint8_t pgm, uint8_t size,
+		color_t color, color_t bg_color) {
+	char c;
+
+	for (; len != 0; len--, s++) {
+		c = text_char(s, pgm);
+		if (c != '\r') {
+			x = drawChar(x, y, c, size, color, bg_color);
+		}
+	}
+
+	return x;
+}
+
+//Draws the digits of val from the highest power of base down, so no string buffer is needed.
+//width is the min. count of characters including the sign, pad is ' ' or '0'.
+uint16_t MI0283QT2::draw_number(uint16_t x, uint16_t y, unsigned long val, uint8_t negative, uint8_t base,
+		uint8_t width, char pad, uint8_t size, color_t color, color_t bg_color) {
+	PROFILE(LCD_PROFILE_TEXT);
+	unsigned long power;
+	uint8_t digits, digit;
+
+	if ((base < 2) || (base > 36)) {
+		base = DEC;
+	}
+
+	for (power = 1, digits = 1; (val / base) >= power; power *= base) {
+		digits++;
+	}
+	if (negative) {
+		digits++;
+		if (pad == '0') //sign before zeros
+		{
+			x = drawChar(x, y, '-', size, color, bg_color);
+		}
+	}
+	for (; (width > digits) && (x <= lcd_width); width--) {
+		x = drawChar(x, y, pad, size, color, bg_color);
+	}
+	if (negative && (pad != '0')) {
+		x = drawChar(x, y, '-', size, color, bg_color);
+	}
+
+	for (; (power != 0) && (x <= lcd_width); power /= base) {
+		digit = val / power;
+		val -= digit * power;
+		x = drawChar(x, y, (digit < 10) ? ('0' + digit) : ('A' - 10 + digit), size, color, bg_color);
+	}
+
+	return x;
+}
+
+//Tries the dividers from fast to slow and returns the first one that reads back all test patterns.
+uint8_t MI0283QT2::clock_calibrate(void) {
+#if !defined(LCD_USART_SPI) && !defined(SOFTWARE_SPI)
+	uint8_t div;
+
+	for (div = 2; div <= 32; div <<= 1) {
+		lcd_clock(div);
+		if (clock_test()) {
+			return div;
+		}
+	}
+#endif
+	lcd_clock(CLOCK_FALLBACK);
+
+	return CLOCK_FALLBACK;
+}
+
+//Writes patterns to the window registers (x0, x1, y0, y1 low byte) and reads them back.
+//The window is set again by the next setArea().
+uint8_t MI0283QT2::clock_test(void) {
+	static const prog_uint8_t pattern_PGM[8] PROGMEM = { 0x55, 0xAA, 0x00, 0xFF, 0x0F, 0xF0, 0x3C, 0xC3 };
+	uint8_t i, reg, p;
+
+	for (i = 0; i < 32; i++) {
+		reg = 0x03 + ((i & 3) << 1);
+		p = pgm_read_byte(&pattern_PGM[i & 7]) ^ (i >> 3);
+		wr_cmd(reg, p);
+		if (rd_cmd(reg) != p) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 void MI0283QT2::wr_cmd(uint8_t reg, uint8_t param) {
 	CS_ENABLE();
 	wr_spi(LCD_REGISTER);
@@ -1170,6 +2023,26 @@ void MI0283QT2::wr_cmd(uint8_t reg, uint8_t param) {
 	return;
 }
 
+uint8_t MI0283QT2::rd_cmd(uint8_t reg) {
+	uint8_t param;
+
+	CS_ENABLE();
+	wr_spi(LCD_REGISTER);
+	wr_spi(reg);
+	CS_DISABLE();
+
+	CS_ENABLE();
+	wr_spi(LCD_DATA | 0x01); //RW=1
+#if defined(LCD_USART_SPI)
+	param = 0; //no MISO
+#else
+	param = SPIBus::transfer(0x00);
+#endif
+	CS_DISABLE();
+
+	return param;
+}
+
 void MI0283QT2::wr_data(uint16_t data) {
 	CS_ENABLE();
 	wr_spi(LCD_DATA);
@@ -1181,38 +2054,12 @@ void MI0283QT2::wr_data(uint16_t data) {
 }
 
 void MI0283QT2::wr_spi(uint8_t data) {
-#if defined(SOFTWARE_SPI)
-	uint8_t mask;
-
-	for(mask=0x80; mask!=0; mask>>=1)
-	{
-		CLK_LOW();
-		if(mask & data)
-		{
-			MOSI_HIGH();
-		}
-		else
-		{
-			MOSI_LOW();
-		}
-		CLK_HIGH();
-	}
-	CLK_LOW();
-
+	PROFILE_BYTES(1);
+#if defined(LCD_USART_SPI)
+	usart_tx(data);
 #else
-	SPDR = data;
-	while (!(SPSR & (1 << SPIF)))
-		;
+	SPIBus::write(data);
 #endif
 
 	return;
 }
-
-void MI0283QT2::delay_10ms(uint8_t ms) //delay of 10ms * x
-		{
-	for (; ms != 0; ms--) {
-		_delay_ms(10);
-	}
-
-	return;
-}
@@ -14,14 +14,95 @@ extern "C" {
 #include "Print.h"
 
 
+//Palette mode: all colors are 8 bit indices into a RGB565 palette in RAM (select only if needed)
+//#define LCD_PALETTE
+#define LCD_PALETTE_SIZE (16) //16 or 256 entries
+
+//Print: collect characters and draw them line by line, flush() draws a partial line (select only if needed)
+//#define PRINT_BUFFERED
+#define PRINT_BUFFER_SIZE (40) //chars, one line of the 8x12 font
+
+//Profiling: calls, pixels and time per primitive, SPI bytes and setArea() calls in MI0283QT2::profile (select only if needed)
+//#define LCD_PROFILE
+
+#define LCD_CLOCK_AUTO (0) //init(): fastest clock_div that reads back test patterns from the display
+
 #define RGB(r,g,b)   (((r&0xF8)<<8)|((g&0xFC)<<3)|((b&0xF8)>>3)) //5 red | 6 green | 5 blue
 
-#define COLOR_WHITE  RGB(255,255,255)
-#define COLOR_BLACK  RGB(  0,  0,  0)
-#define COLOR_RED    RGB(255,  0,  0)
-#define COLOR_GREEN  RGB(  0,255,  0)
-#define COLOR_BLUE   RGB(  0,  0,255)
-#define COLOR_YELLOW RGB(255,255,  0)
+#if defined(LCD_PALETTE)
+typedef uint8_t color_t; //palette index
+# define COLOR_WHITE  (0)
+# define COLOR_BLACK  (1)
+# define COLOR_RED    (2)
+# define COLOR_GREEN  (3)
+# define COLOR_BLUE   (4)
+# define COLOR_YELLOW (5)
+# define COLOR_GRAY   (6)
+# define COLOR_TRANSPARENT (0xFF) //bg_color of text: the background is not drawn (no palette entry with 256 colors)
+# if LCD_PALETTE_SIZE < 256
+#  define COLOR_TO_RGB565(c) (MI0283QT2::palette[(c) & (LCD_PALETTE_SIZE - 1)])
+# else
+#  define COLOR_TO_RGB565(c) (MI0283QT2::palette[(c)])
+# endif
+#else
+typedef uint16_t color_t; //RGB565 value
+# define COLOR_WHITE  RGB(255,255,255)
+# define COLOR_BLACK  RGB(  0,  0,  0)
+# define COLOR_RED    RGB(255,  0,  0)
+# define COLOR_GREEN  RGB(  0,255,  0)
+# define COLOR_BLUE   RGB(  0,  0,255)
+# define COLOR_YELLOW RGB(255,255,  0)
+# define COLOR_GRAY   RGB(180,180,180)
+# define COLOR_TRANSPARENT RGB(0,0,8) //bg_color of text: the background is not drawn (this blue can't be a background)
+# define COLOR_TO_RGB565(c) (c)
+#endif
+
+#define LCD_POLYGON_MAX_POINTS (8) //max. points of fillPolygon()
+
+typedef struct
+{
+  int16_t x;
+  int16_t y;
+} LCD_POINT;
+
+#define LCD_CLIP_DEPTH (4) //max. nested pushClip() calls
+
+typedef struct
+{
+  int16_t x0, y0;
+  int16_t x1, y1;
+} LCD_RECT;
+
+#define LCD_PROFILE_PIXEL   (0) //drawPixel, drawPixelFast
+#define LCD_PROFILE_LINE    (1) //drawLine, drawLineFastOneX, drawRect, fillCapsule
+#define LCD_PROFILE_FILL    (2) //clear, fillRect
+#define LCD_PROFILE_CIRCLE  (3) //drawCircle, fillCircle
+#define LCD_PROFILE_POLYGON (4) //fillTriangle, fillPolygon
+#define LCD_PROFILE_TEXT    (5) //drawChar, drawText, drawMLText, drawInteger, print
+#define LCD_PROFILE_COUNT   (6)
+
+typedef struct
+{
+  uint16_t calls;
+  uint32_t pixels;
+  uint32_t us; //micros(), resolution 4us at 16MHz
+} LCD_PROFILE_ENTRY;
+
+typedef struct
+{
+  LCD_PROFILE_ENTRY primitive[LCD_PROFILE_COUNT];
+  uint32_t spi_bytes;
+  uint16_t areas; //setArea() calls
+  uint8_t depth, current;
+  uint32_t start;
+} LCD_PROFILE_DATA;
+
+//one glyph row or column as bit mask (first pixel = MSB)
+#if (FONT_WIDTH <= 16) && (FONT_HEIGHT <= 16)
+typedef uint16_t glyph_line_t;
+#else
+typedef uint32_t glyph_line_t;
+#endif
 
 #ifndef DEC
 # define DEC (10)
@@ -43,48 +124,78 @@ class MI0283QT2 : public Print
     uint16_t lcd_orientation;
     uint16_t lcd_width, lcd_height;
 
-    MI0283QT2();
-    void init(uint8_t clock_div); //2 4 8 16 32
+#if defined(LCD_PALETTE)
+    static uint16_t palette[LCD_PALETTE_SIZE]; //RGB565 values
+#endif
+#if defined(LCD_PROFILE)
+    static LCD_PROFILE_DATA profile; //shared by all instances
+#endif
+
+    MI0283QT2(uint8_t id = 0); //LCD_ID: 0 or 1 (ID pin of the display), several displays on one SPI bus
+    void init(uint8_t clock_div); //2 4 8 16 32 or LCD_CLOCK_AUTO
+    void initStart(uint8_t clock_div); //non-blocking init, starts the reset, call initService() until it returns 0 before drawing
+    uint8_t initService(void); //returns 1 while the init sequence is running
+    uint8_t getClock(void); //clock_div in use
+#if defined(LCD_PROFILE)
+    static void profileReset(void);
+#endif
+    uint32_t measureFillRate(void); //pixels/s of a fill, only the top left pixel is written (black)
     void led(uint8_t power); //0-100
 
+#if defined(LCD_PALETTE)
+    void setPaletteColor(uint8_t index, uint16_t rgb565);
+    uint16_t getPaletteColor(uint8_t index);
+    void setPalettePGM(const prog_uint16_t *p, uint8_t first, uint8_t count);
+#endif
+
     void setOrientation(uint16_t o); //0 90 180 270
     uint16_t getWidth(void);
     uint16_t getHeight(void);
     void setArea(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
     void setCursor(uint16_t x, uint16_t y);
+    uint8_t pushClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1); //returns 1 if the clip stack is full
+    void popClip(void);
+    void resetClip(void);
 
-    void clear(uint16_t color);
+    void clear(color_t color);
     void drawStart(void);
-    inline void draw(uint16_t color);
+    inline void draw(uint16_t color); //RGB565
     inline void drawStop(void);
-    void drawPixel(uint16_t x0, uint16_t y0, uint16_t color);
-    void drawPixelFast(uint16_t x0,uint8_t y0, uint16_t color);
-    void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
-    void drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, uint16_t color);
-    void drawRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
-    void fillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t color);
-    void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t color);
-    void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, uint16_t color);
-
-    uint16_t drawChar(uint16_t x, uint16_t y, char c, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, char *s, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, int i, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, unsigned int i, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, long l, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, unsigned long l, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawText(uint16_t x, uint16_t y, String &s, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawTextPGM(uint16_t x, uint16_t y, PGM_P s, uint8_t size, uint16_t color, uint16_t bg_color);
-
-    uint16_t drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, char *s, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, String &s, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawMLTextPGM(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, PGM_P s, uint8_t size, uint16_t color, uint16_t bg_color);
-
-    uint16_t drawInteger(uint16_t x, uint16_t y, char val, uint8_t base, uint8_t size, uint16_t color, uint16_t bg_color); //base = DEC, HEX, OCT, BIN
-    uint16_t drawInteger(uint16_t x, uint16_t y, unsigned char val, uint8_t base, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t size, uint16_t color, uint16_t bg_color);
-    uint16_t drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t size, uint16_t color, uint16_t bg_color);
-
-    void printOptions(uint8_t size, uint16_t color, uint16_t bg_color);
+    void drawPixel(uint16_t x0, uint16_t y0, color_t color);
+    void drawPixelFast(uint16_t x0,uint8_t y0, color_t color);
+    void drawLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color);
+    void drawLineFastOneX(uint16_t x0, uint16_t y0, uint16_t y1, color_t color);
+    void drawRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color);
+    void fillRect(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, color_t color);
+    void drawCircle(uint16_t x0, uint16_t y0, uint16_t radius, color_t color);
+    void fillCircle(uint16_t x0, uint16_t y0, uint16_t radius, color_t color);
+    void fillCapsule(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t radius, color_t color); //thick line with round caps, radius 0 = drawLine
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, color_t color);
+    void fillPolygon(const LCD_POINT *p, uint8_t count, color_t color); //max. LCD_POLYGON_MAX_POINTS
+
+    uint16_t drawChar(uint16_t x, uint16_t y, char c, uint8_t size, color_t color, color_t bg_color); //bg_color = COLOR_TRANSPARENT: foreground pixels only
+    uint16_t drawText(uint16_t x, uint16_t y, char *s, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawText(uint16_t x, uint16_t y, int i, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawText(uint16_t x, uint16_t y, unsigned int i, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawText(uint16_t x, uint16_t y, long l, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawText(uint16_t x, uint16_t y, unsigned long l, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawText(uint16_t x, uint16_t y, String &s, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawTextPGM(uint16_t x, uint16_t y, PGM_P s, uint8_t size, color_t color, color_t bg_color);
+
+    uint16_t drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, char *s, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawMLText(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, String &s, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawMLTextPGM(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, PGM_P s, uint8_t size, color_t color, color_t bg_color);
+
+    uint16_t drawInteger(uint16_t x, uint16_t y, char val, uint8_t base, uint8_t size, color_t color, color_t bg_color); //base = DEC, HEX, OCT, BIN
+    uint16_t drawInteger(uint16_t x, uint16_t y, unsigned char val, uint8_t base, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawInteger(uint16_t x, uint16_t y, int val, uint8_t base, uint8_t width, char pad, uint8_t size, color_t color, color_t bg_color); //width = min. chars, pad = ' ' or '0'
+    uint16_t drawInteger(uint16_t x, uint16_t y, unsigned int val, uint8_t base, uint8_t width, char pad, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawInteger(uint16_t x, uint16_t y, long val, uint8_t base, uint8_t width, char pad, uint8_t size, color_t color, color_t bg_color);
+    uint16_t drawInteger(uint16_t x, uint16_t y, unsigned long val, uint8_t base, uint8_t width, char pad, uint8_t size, color_t color, color_t bg_color);
+
+    void printOptions(uint8_t size, color_t color, color_t bg_color);
     void printClear(void);
     void printXY(uint16_t x, uint16_t y);
     uint16_t printGetX(void);
@@ -93,17 +204,52 @@ class MI0283QT2 : public Print
     virtual size_t write(uint8_t c);
     virtual size_t write(const char *s);
     virtual size_t write(const uint8_t *s, size_t size);
+#if defined(PRINT_BUFFERED)
+    void flush(void);
+#endif
 
   private:
+    uint8_t lcd_start; //SPI start byte with LCD_ID
+    uint8_t init_pos, init_clock;
+    uint16_t init_time; //millis() of the next init step
     uint8_t p_size;
-    uint16_t p_fg, p_bg;
+    color_t p_fg, p_bg;
     uint16_t p_x, p_y;
+#if defined(PRINT_BUFFERED)
+    char p_buf[PRINT_BUFFER_SIZE];
+    uint8_t p_len;
+#endif
+    LCD_RECT clip;
+    LCD_RECT clip_stack[LCD_CLIP_DEPTH];
+    uint8_t clip_depth;
 
-    void reset(void);
+    uint8_t clock_calibrate(void);
+    uint8_t clock_test(void);
     void wr_cmd(uint8_t reg, uint8_t param);
+    uint8_t rd_cmd(uint8_t reg);
     void wr_data(uint16_t data);
     void wr_spi(uint8_t data);
-    void delay_10ms(uint8_t ms);
+    void fill_area(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t rgb);
+    void draw_repeat(uint16_t rgb, uint32_t size);
+    void draw_hspan(int16_t x0, int16_t x1, int16_t y, uint16_t rgb);
+    void draw_vspan(int16_t x, int16_t y0, int16_t y1, uint16_t rgb);
+    void draw_char_clipped(uint16_t x, uint16_t y, const prog_uint8_t *ptr, uint8_t size, uint16_t fg, uint16_t bg);
+    void draw_char_transparent(uint16_t x, uint16_t y, const prog_uint8_t *ptr, uint8_t size, uint16_t rgb);
+    uint8_t glyph_runs(uint16_t x, uint16_t y, const glyph_line_t *lines, uint8_t count, uint8_t bits, uint8_t size,
+        uint8_t vertical, uint8_t draw, uint16_t rgb);
+    uint8_t clip_contains(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+#if defined(PRINT_BUFFERED)
+    void print_line(uint8_t eol);
+#endif
+    void fill_clipped(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t rgb);
+    uint16_t draw_ml_text(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, const char *s, uint8_t pgm, uint8_t size,
+        color_t color, color_t bg_color);
+    void draw_text_run(uint16_t x0, uint16_t y, uint16_t x1, uint16_t rows, const char *s, uint8_t len, uint8_t pgm,
+        uint8_t size, uint16_t fg, uint16_t bg);
+    uint16_t draw_number(uint16_t x, uint16_t y, unsigned long val, uint8_t negative, uint8_t base, uint8_t width, char pad,
+        uint8_t size, color_t color, color_t bg_color);
+    uint16_t draw_text_chars(uint16_t x, uint16_t y, const char *s, uint8_t len, uint8_t pgm, uint8_t size,
+        color_t color, color_t bg_color);
 };
 
 
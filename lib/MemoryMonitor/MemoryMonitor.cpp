@@ -0,0 +1,151 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <inttypes.h>
+#include <stdlib.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#if !defined(__AVR__)
+#include <unistd.h>
+#endif
+#ifdef __cplusplus
+}
+#endif
+#include "MemoryMonitor.h"
+
+
+#if defined(__AVR__)
+
+extern uint8_t __data_start, __bss_end, __heap_start;
+extern char *__brkval; //0 as long as malloc() was never called
+
+void memory_init_paint(void) __attribute__ ((naked, used, section(".init3")));
+
+//runs before the static constructors, SP is already set and nothing is on the stack
+void memory_init_paint(void) {
+	uint8_t *p = &__heap_start;
+
+	while (p <= (uint8_t *) SP) {
+		*p++ = MEMORY_CANARY;
+	}
+}
+
+#define PAINT_START (MemoryMonitor::heapTop())
+#define PAINT_END   ((uint8_t *) SP)
+#define PGM_READ_PTR(p) ((PGM_P) pgm_read_word(p))
+
+#else //Linux: watch a window of the stack below the caller of paint()
+
+extern char __data_start, end; //set by the GNU linker
+
+static uint8_t *paint_low;
+
+static void __attribute__ ((noinline)) paint_window(void) {
+	volatile uint8_t window[MEMORY_HOST_STACK];
+	uint16_t i;
+
+	for (i = 0; i < sizeof(window); i++) {
+		window[i] = MEMORY_CANARY;
+	}
+	paint_low = (uint8_t *) window;
+
+	return;
+}
+
+#define PAINT_START (paint_low)
+#define PAINT_END   (paint_low + MEMORY_HOST_STACK)
+#define PGM_READ_PTR(p) (*(p)) //tables are in RAM
+
+#endif
+
+static void print_pgm(Print *p, PGM_P s) {
+	char c;
+
+	while ((c = pgm_read_byte(s++)) != 0) {
+		p->write((uint8_t) c);
+	}
+
+	return;
+}
+
+//-------------------- Public --------------------
+
+void MemoryMonitor::paint(void) {
+#if defined(__AVR__)
+	uint8_t *p;
+
+	for (p = PAINT_START; p < PAINT_END; p++) {
+		*p = MEMORY_CANARY;
+	}
+#else
+	paint_window();
+#endif
+
+	return;
+}
+
+uint16_t MemoryMonitor::freeStackMin(void) {
+	uint8_t *p = PAINT_START, *e = PAINT_END;
+
+	if (p == 0) {
+		return 0;
+	}
+	while ((p < e) && (*p == MEMORY_CANARY)) {
+		p++;
+	}
+
+	return (uint16_t) (p - PAINT_START);
+}
+
+uint16_t MemoryMonitor::freeRam(void) {
+#if defined(__AVR__)
+	return (uint16_t) ((uint8_t *) SP - heapTop());
+#else
+	uint8_t sp;
+
+	if ((paint_low == 0) || (&sp < paint_low)) {
+		return 0;
+	}
+	return (&sp < PAINT_END) ? (uint16_t) (&sp - paint_low) : MEMORY_HOST_STACK;
+#endif
+}
+
+uint8_t *MemoryMonitor::heapTop(void) {
+#if defined(__AVR__)
+	return (__brkval == 0) ? &__heap_start : (uint8_t *) __brkval;
+#else
+	return (uint8_t *) sbrk(0);
+#endif
+}
+
+uint16_t MemoryMonitor::staticRam(void) {
+#if defined(__AVR__)
+	return (uint16_t) (&__bss_end - &__data_start);
+#else
+	return (uint16_t) (&end - &__data_start);
+#endif
+}
+
+void MemoryMonitor::dump(Print *p, const MEMORY_SUBSYSTEM *table, uint8_t count) {
+	uint16_t bytes;
+
+	print_pgm(p, PSTR("ram="));
+	p->print(staticRam());
+	print_pgm(p, PSTR(" heap=0x"));
+	p->print((unsigned long) heapTop(), HEX);
+	print_pgm(p, PSTR(" free="));
+	p->print(freeRam());
+	print_pgm(p, PSTR(" min="));
+	p->print(freeStackMin());
+	p->write('\n');
+	for (; count != 0; count--, table++) {
+		print_pgm(p, PGM_READ_PTR(&table->name));
+		p->write('=');
+		bytes = pgm_read_word(&table->bytes);
+		p->print(bytes);
+		p->write(' ');
+	}
+	p->write('\n');
+
+	return;
+}
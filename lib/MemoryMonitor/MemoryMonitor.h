@@ -0,0 +1,40 @@
+#ifndef MemoryMonitor_h
+#define MemoryMonitor_h
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  #include <inttypes.h>
+  #include <avr/pgmspace.h>
+#ifdef __cplusplus
+}
+#endif
+#include "Print.h"
+
+
+#define MEMORY_CANARY     (0xC5) //pattern painted into free RAM
+#define MEMORY_HOST_STACK (16384) //not AVR: bytes of stack below the caller of paint() that are watched
+
+typedef struct
+{
+  PGM_P name; //PROGMEM string
+  uint16_t bytes; //sizeof of the objects
+} MEMORY_SUBSYSTEM; //table in PROGMEM, see dump()
+
+
+class MemoryMonitor
+{
+  public:
+    //AVR: free RAM is painted before the static constructors run (.init3), call again to restart the high-water mark
+    //not AVR: call first in setup()
+    static void paint(void);
+    static uint16_t freeStackMin(void); //bytes never used by the stack since paint()
+    static uint16_t freeRam(void); //bytes between heap top and stack pointer now
+    static uint8_t *heapTop(void);
+    static uint16_t staticRam(void); //.data + .bss
+    static void dump(Print *p, const MEMORY_SUBSYSTEM *table, uint8_t count); //table and count may be 0
+};
+
+
+#endif //MemoryMonitor_h
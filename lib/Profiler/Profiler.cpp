@@ -0,0 +1,152 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <inttypes.h>
+#include <avr/pgmspace.h>
+#ifdef __cplusplus
+}
+#endif
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "Profiler.h"
+
+static const char section_names_PGM[] PROGMEM = "T\0H\0D\0I"; //overlay: touch, hit test, draw, idle
+static const char section_text_PGM[] PROGMEM = "touch \0hit   \0draw  \0idle  ";
+#if defined(LCD_PROFILE)
+static const char primitive_text_PGM[] PROGMEM = "pixel   \0line    \0fill    \0circle  \0polygon \0text    ";
+#endif
+
+uint32_t Profiler::us[PROFILER_SECTIONS];
+uint32_t Profiler::start;
+uint32_t Profiler::loops;
+uint8_t Profiler::current = PROFILER_IDLE;
+
+static void print_pgm(Print *p, PGM_P s) {
+	char c;
+
+	while ((c = pgm_read_byte(s++)) != 0) {
+		p->write((uint8_t) c);
+	}
+
+	return;
+}
+
+//returns the n-th string of a list of 0 terminated strings
+static PGM_P pgm_string(PGM_P s, uint8_t n) {
+	for (; n != 0; n--) {
+		while (pgm_read_byte(s++) != 0) {
+			;
+		}
+	}
+
+	return s;
+}
+
+//-------------------- Public --------------------
+
+void Profiler::loop(void) {
+	loops++;
+	section(PROFILER_IDLE);
+
+	return;
+}
+
+void Profiler::section(uint8_t s) {
+	uint32_t now = micros();
+	uint8_t i;
+
+	us[current] += now - start;
+	start = now;
+	if (us[current] & 0xE0000000UL) { //keeps the sum of all sections below 2^31, the ratios stay
+		for (i = 0; i < PROFILER_SECTIONS; i++) {
+			us[i] >>= 1;
+		}
+		loops >>= 1;
+	}
+	current = s;
+
+	return;
+}
+
+void Profiler::reset(void) {
+	uint8_t i;
+
+	for (i = 0; i < PROFILER_SECTIONS; i++) {
+		us[i] = 0;
+	}
+	loops = 0;
+	start = micros();
+#if defined(LCD_PROFILE)
+	MI0283QT2::profileReset();
+#endif
+
+	return;
+}
+
+void Profiler::draw(MI0283QT2 *lcd, uint16_t x, uint16_t y, color_t color, color_t bg_color) {
+	uint32_t t = total(), rate;
+	uint8_t i;
+
+	if (t == 0) {
+		return;
+	}
+	for (i = 0; i < PROFILER_SECTIONS; i++) {
+		x = lcd->drawTextPGM(x, y, pgm_string(section_names_PGM, i), 1, color, bg_color);
+		x = lcd->drawInteger(x, y, (unsigned int) (us[i] / (t / 100 + 1)), DEC, 3, ' ', 1, color, bg_color); //no us*100 overflow
+		x = lcd->drawTextPGM(x, y, PSTR("% "), 1, color, bg_color);
+	}
+	if (loops < (0xFFFFFFFFUL / 1000UL)) {
+		rate = (loops * 1000UL) / (t / 1000UL + 1);
+	} else { //> 4.2 million loops
+		rate = loops / (t / 1000000UL + 1);
+	}
+	x = lcd->drawInteger(x, y, (unsigned long) rate, DEC, 5, ' ', 1, color, bg_color);
+	lcd->drawTextPGM(x, y, PSTR("/s"), 1, color, bg_color);
+
+	return;
+}
+
+void Profiler::dump(Print *p) {
+	uint8_t i;
+
+	print_pgm(p, PSTR("loops "));
+	p->println(loops);
+	for (i = 0; i < PROFILER_SECTIONS; i++) {
+		print_pgm(p, pgm_string(section_text_PGM, i));
+		p->print(us[i]);
+		print_pgm(p, PSTR(" us\n"));
+	}
+#if defined(LCD_PROFILE)
+	print_pgm(p, PSTR("primitive calls pixels us\n"));
+	for (i = 0; i < LCD_PROFILE_COUNT; i++) {
+		print_pgm(p, pgm_string(primitive_text_PGM, i));
+		p->print((unsigned int) MI0283QT2::profile.primitive[i].calls);
+		p->print(' ');
+		p->print(MI0283QT2::profile.primitive[i].pixels);
+		p->print(' ');
+		p->println(MI0283QT2::profile.primitive[i].us);
+	}
+	print_pgm(p, PSTR("spi bytes "));
+	p->println(MI0283QT2::profile.spi_bytes);
+	print_pgm(p, PSTR("setArea "));
+	p->println((unsigned int) MI0283QT2::profile.areas);
+#endif
+
+	return;
+}
+
+//-------------------- Private --------------------
+
+uint32_t Profiler::total(void) {
+	uint32_t t = 0;
+	uint8_t i;
+
+	for (i = 0; i < PROFILER_SECTIONS; i++) {
+		t += us[i];
+	}
+
+	return t;
+}
@@ -0,0 +1,53 @@
+#ifndef Profiler_h
+#define Profiler_h
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  #include <inttypes.h>
+#ifdef __cplusplus
+}
+#endif
+#include "Print.h"
+#include "../MI0283QT2/MI0283QT2.h"
+
+
+//Loop profiler: time per section of loop() (select only if needed, otherwise the macros are empty)
+//#define LOOP_PROFILE
+
+#define PROFILER_TOUCH    (0) //TouchPanel.service()
+#define PROFILER_HIT      (1) //checkAllButtons(), checkAllSliders()
+#define PROFILER_DRAW     (2) //application drawing
+#define PROFILER_IDLE     (3) //rest of loop()
+#define PROFILER_SECTIONS (4)
+
+#if defined(LOOP_PROFILE)
+# define PROFILER_LOOP()      Profiler::loop()
+# define PROFILER_SECTION(s)  Profiler::section(s)
+#else
+# define PROFILER_LOOP()
+# define PROFILER_SECTION(s)
+#endif
+
+
+class Profiler
+{
+  public:
+    static void loop(void); //first statement of loop(): counts loops and starts PROFILER_IDLE
+    static void section(uint8_t s); //ends the running section and starts s
+    static void reset(void); //not needed against overflows: all sums are halved before they reach 2^29 us (9 min)
+    static void draw(MI0283QT2 *lcd, uint16_t x, uint16_t y, color_t color, color_t bg_color); //one line: % per section, loops/s
+    static void dump(Print *p); //e.g. &Serial, with LCD_PROFILE also the MI0283QT2 counters
+
+  private:
+    static uint32_t us[PROFILER_SECTIONS];
+    static uint32_t start;
+    static uint32_t loops;
+    static uint8_t current;
+
+    static uint32_t total(void);
+};
+
+
+#endif //Profiler_h
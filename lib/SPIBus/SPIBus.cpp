@@ -0,0 +1,198 @@
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <inttypes.h>
+#include <avr/io.h>
+#ifdef __cplusplus
+}
+#endif
+#if ARDUINO >= 100
+#include "Arduino.h"
+#else
+#include "WProgram.h"
+#endif
+#include "../digitalWriteFast/digitalWriteFast.h"
+#include "SPIBus.h"
+#include "pins.h"
+
+#if defined(SOFTWARE_SPI)
+//one bit, mode 0: MOSI changes while CLK is low, the slave samples on the rising edge
+# define SOFT_WRITE_BIT(bit) \
+	CLK_LOW(); \
+	if (data & (1 << (bit))) { MOSI_HIGH(); } else { MOSI_LOW(); } \
+	CLK_HIGH();
+# define SOFT_TRANSFER_BIT(bit) \
+	if (data & (1 << (bit))) { MOSI_HIGH(); } else { MOSI_LOW(); } \
+	CLK_HIGH(); \
+	if (MISO_READ()) { in |= (1 << (bit)); } \
+	CLK_LOW();
+# define SOFT_PIN (*__digitalPinToPINReg(CLK_PIN)) //constant address -> out instruction, writing 1 toggles the PORT bit
+#endif
+
+uint8_t SPIBus::active = SPI_DEVICE_NONE;
+uint8_t SPIBus::spcr[SPI_DEVICES] = { (1 << SPE) | (1 << MSTR) | (1 << SPR0), (1 << SPE) | (1 << MSTR) | (1 << SPR0) }; //clk=Fcpu/16
+uint8_t SPIBus::spsr[SPI_DEVICES] = { (1 << SPI2X), (1 << SPI2X) }; //clk*2 -> clk=Fcpu/8
+
+//-------------------- Public --------------------
+
+void SPIBus::begin(void) {
+	//init pins
+	pinMode(CLK_PIN, OUTPUT);
+	pinMode(MOSI_PIN, OUTPUT);
+	pinMode(MISO_PIN, INPUT);
+	digitalWriteFast(MISO_PIN, HIGH);
+	//pull-up
+
+#if !defined(SOFTWARE_SPI)
+	SS_PULLUP();
+#endif
+	active = SPI_DEVICE_NONE;
+
+	return;
+}
+
+void SPIBus::setClock(uint8_t device, uint8_t clock_div) {
+	uint8_t cr, sr;
+
+	switch (clock_div) {
+	case 2:
+		cr = (1 << SPE) | (1 << MSTR); //enable SPI, Master, clk=Fcpu/4
+		sr = (1 << SPI2X); //clk*2 = Fcpu/2
+		break;
+	case 4:
+		cr = (1 << SPE) | (1 << MSTR); //enable SPI, Master, clk=Fcpu/4
+		sr = (0 << SPI2X); //clk*2 = off
+		break;
+	case 8:
+		cr = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
+		sr = (1 << SPI2X); //clk*2 = Fcpu/8
+		break;
+	case 16:
+		cr = (1 << SPE) | (1 << MSTR) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/16
+		sr = (0 << SPI2X); //clk*2 = off
+		break;
+	case 32:
+		cr = (1 << SPE) | (1 << MSTR) | (1 << SPR1); //enable SPI, Master, clk=Fcpu/64
+		sr = (1 << SPI2X); //clk*2 = Fcpu/32
+		break;
+	case 64:
+		cr = (1 << SPE) | (1 << MSTR) | (1 << SPR1); //enable SPI, Master, clk=Fcpu/64
+		sr = (0 << SPI2X); //clk*2 = off
+		break;
+	default: //128
+		cr = (1 << SPE) | (1 << MSTR) | (1 << SPR1) | (1 << SPR0); //enable SPI, Master, clk=Fcpu/128
+		sr = (0 << SPI2X); //clk*2 = off
+		break;
+	}
+	spcr[device] = cr;
+	spsr[device] = sr;
+
+	if (device == active) //reload
+	{
+		select(device);
+	}
+
+	return;
+}
+
+void SPIBus::writeRepeat(uint16_t data, uint32_t count) {
+#if defined(SOFTWARE_SPI)
+	if (__digitalPinToPortReg(MOSI_PIN) == __digitalPinToPortReg(CLK_PIN)) {
+		//MOSI and CLK on one port: the toggle masks of all 16 bits are computed once, then every bit
+		//is two writes to the PIN register (out). A 1 toggles the port bit, so other pins of the port
+		//are never written, also if an interrupt changes them during a fill.
+		//CLK high/low is only 1-2 cycles, this is fast enough for the display but not for the ADS7846.
+		uint8_t t[16], clk, mosi, i;
+		uint16_t d, prev;
+
+		clk = (1 << __digitalPinToBit(CLK_PIN));
+		mosi = (1 << __digitalPinToBit(MOSI_PIN));
+		prev = data << 15; //bit 0 of the previous word
+		for (i = 0, d = data; i < 16; i++) {
+			t[i] = clk; //CLK high -> low
+			if ((d ^ prev) & 0x8000) { //MOSI changes
+				t[i] |= mosi;
+			}
+			prev = d;
+			d <<= 1;
+		}
+		//CLK low and MOSI = bit 15, then every word ends with t[0]: CLK low, MOSI = bit 15 of the next word
+		CLK_LOW();
+		if (data & 0x8000) {
+			MOSI_HIGH();
+		} else {
+			MOSI_LOW();
+		}
+		for (; count != 0; count--) {
+			SOFT_PIN = clk; SOFT_PIN = t[1];
+			SOFT_PIN = clk; SOFT_PIN = t[2];
+			SOFT_PIN = clk; SOFT_PIN = t[3];
+			SOFT_PIN = clk; SOFT_PIN = t[4];
+			SOFT_PIN = clk; SOFT_PIN = t[5];
+			SOFT_PIN = clk; SOFT_PIN = t[6];
+			SOFT_PIN = clk; SOFT_PIN = t[7];
+			SOFT_PIN = clk; SOFT_PIN = t[8];
+			SOFT_PIN = clk; SOFT_PIN = t[9];
+			SOFT_PIN = clk; SOFT_PIN = t[10];
+			SOFT_PIN = clk; SOFT_PIN = t[11];
+			SOFT_PIN = clk; SOFT_PIN = t[12];
+			SOFT_PIN = clk; SOFT_PIN = t[13];
+			SOFT_PIN = clk; SOFT_PIN = t[14];
+			SOFT_PIN = clk; SOFT_PIN = t[15];
+			SOFT_PIN = clk; SOFT_PIN = t[0];
+		}
+		return;
+	}
+#endif
+	for (; count != 0; count--) {
+		write(data >> 8);
+		write(data);
+	}
+
+	return;
+}
+
+//-------------------- Private --------------------
+
+void SPIBus::select(uint8_t device) {
+#if !defined(SOFTWARE_SPI)
+	SPCR = spcr[device];
+	SPSR = spsr[device];
+#endif
+	active = device;
+
+	return;
+}
+
+#if defined(SOFTWARE_SPI)
+void SPIBus::soft_write(uint8_t data) //unrolled
+		{
+	SOFT_WRITE_BIT(7);
+	SOFT_WRITE_BIT(6);
+	SOFT_WRITE_BIT(5);
+	SOFT_WRITE_BIT(4);
+	SOFT_WRITE_BIT(3);
+	SOFT_WRITE_BIT(2);
+	SOFT_WRITE_BIT(1);
+	SOFT_WRITE_BIT(0);
+	CLK_LOW();
+
+	return;
+}
+
+uint8_t SPIBus::soft_transfer(uint8_t data) //unrolled
+		{
+	uint8_t in = 0;
+
+	SOFT_TRANSFER_BIT(7);
+	SOFT_TRANSFER_BIT(6);
+	SOFT_TRANSFER_BIT(5);
+	SOFT_TRANSFER_BIT(4);
+	SOFT_TRANSFER_BIT(3);
+	SOFT_TRANSFER_BIT(2);
+	SOFT_TRANSFER_BIT(1);
+	SOFT_TRANSFER_BIT(0);
+
+	return in;
+}
+#endif
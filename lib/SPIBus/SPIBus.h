@@ -0,0 +1,100 @@
+#ifndef SPIBus_h
+#define SPIBus_h
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  #include <inttypes.h>
+  #include <avr/io.h>
+#ifdef __cplusplus
+}
+#endif
+
+
+//Backend (select one, default: hardware SPI)
+//#define SOFTWARE_SPI //bit-banged on the MOSI/MISO/CLK pins
+//#define SPI_MOCK     //host builds: all transfers go to SPIBus::mock (SPIMock.h), e.g. a HX8347Mock framebuffer
+
+#if defined(SPI_MOCK)
+# if defined(SOFTWARE_SPI)
+#  error "SPI_MOCK and SOFTWARE_SPI can't be used together"
+# endif
+# include "SPIMock.h"
+#endif
+
+//Devices on the bus, every device has its own clock settings
+#define SPI_DEVICE_LCD  (0) //MI0283QT2
+#define SPI_DEVICE_TP   (1) //ADS7846
+#define SPI_DEVICES     (2)
+#define SPI_DEVICE_NONE (0xFF)
+
+
+class SPIBus
+{
+  public:
+    static void begin(void); //init bus pins and hardware SPI
+    static void setClock(uint8_t device, uint8_t clock_div); //2 4 8 16 32 64 128
+
+    //Selects the settings of the device, the registers are only written if another device was active.
+    static inline void beginTransaction(uint8_t device)
+    {
+      if (device != active)
+      {
+        select(device);
+      }
+#if defined(SPI_MOCK)
+      mock->begin(device);
+#endif
+    }
+    static inline void endTransaction(void) //nothing to restore, the settings stay until another device begins
+    {
+#if defined(SPI_MOCK)
+      mock->end();
+#endif
+    }
+
+    static inline void write(uint8_t data)
+    {
+#if defined(SOFTWARE_SPI)
+      soft_write(data);
+#elif defined(SPI_MOCK)
+      mock->transfer(data);
+#else
+      SPDR = data;
+      while (!(SPSR & (1 << SPIF)))
+        ;
+#endif
+    }
+    static void writeRepeat(uint16_t data, uint32_t count); //sends data (MSB first) count times, e.g. a RGB565 fill
+    static inline uint8_t transfer(uint8_t data)
+    {
+#if defined(SOFTWARE_SPI)
+      return soft_transfer(data);
+#elif defined(SPI_MOCK)
+      return mock->transfer(data);
+#else
+      SPDR = data;
+      while (!(SPSR & (1 << SPIF)))
+        ;
+      return SPDR;
+#endif
+    }
+
+#if defined(SPI_MOCK)
+    static SPIMock *mock; //set before the devices are initialized, default: counts bytes only
+#endif
+
+  private:
+    static uint8_t active;
+    static uint8_t spcr[SPI_DEVICES], spsr[SPI_DEVICES];
+
+    static void select(uint8_t device);
+#if defined(SOFTWARE_SPI)
+    static void soft_write(uint8_t data);
+    static uint8_t soft_transfer(uint8_t data);
+#endif
+};
+
+
+#endif //SPIBus_h
@@ -0,0 +1,193 @@
+#include "SPIBus.h"
+
+#if defined(SPI_MOCK)
+
+#include <stdio.h>
+#include <string.h>
+#include "SPIMock.h"
+
+#define REG_MEMORY_ACCESS (0x16) //MY MX MV ML BGR
+#define REG_GRAM          (0x22)
+#define MV                (1 << 5) //column/page exchange
+#define MX                (1 << 6) //column mirror
+#define MY                (1 << 7) //page mirror
+
+static SPIMock null_mock; //counts bytes only
+SPIMock *SPIBus::mock = &null_mock;
+
+//-------------------- Public --------------------
+
+HX8347Mock::HX8347Mock(uint8_t id) {
+	lcd_start = 0x70 | ((id & 1) << 2);
+	memset(regs, 0, sizeof(regs));
+	clear(0);
+}
+
+void HX8347Mock::clear(uint16_t color) {
+	uint16_t i, j;
+
+	for (i = 0; i < HX8347_HEIGHT; i++) {
+		for (j = 0; j < HX8347_WIDTH; j++) {
+			gram[i][j] = color;
+		}
+	}
+	clearCounters();
+
+	return;
+}
+
+void HX8347Mock::clearCounters(void) {
+	bytes = 0;
+	transactions = 0;
+	pixels = 0;
+	errors = 0;
+
+	return;
+}
+
+uint8_t HX8347Mock::readRegister(uint8_t reg) {
+	return regs[reg];
+}
+
+uint16_t HX8347Mock::getPixel(uint16_t x, uint16_t y) {
+	if ((x >= HX8347_WIDTH) || (y >= HX8347_HEIGHT)) {
+		return 0;
+	}
+
+	return gram[y][x];
+}
+
+//binary PPM, 8 bit per color
+uint8_t HX8347Mock::savePPM(const char *file) {
+	FILE *f;
+	uint16_t i, j, c;
+
+	f = fopen(file, "wb");
+	if (f == 0) {
+		return 1;
+	}
+	fprintf(f, "P6\n%d %d\n255\n", HX8347_WIDTH, HX8347_HEIGHT);
+	for (i = 0; i < HX8347_HEIGHT; i++) {
+		for (j = 0; j < HX8347_WIDTH; j++) {
+			c = gram[i][j];
+			fputc((c >> 8) & 0xF8, f);
+			fputc((c >> 3) & 0xFC, f);
+			fputc((c << 3) & 0xF8, f);
+		}
+	}
+
+	return (fclose(f) == 0) ? 0 : 1;
+}
+
+int32_t HX8347Mock::comparePPM(const char *file) {
+	FILE *f;
+	int w, h, max;
+	int32_t diff = 0;
+	uint16_t i, j, c;
+	uint8_t rgb[3];
+
+	f = fopen(file, "rb");
+	if (f == 0) {
+		return -1;
+	}
+	if ((fscanf(f, "P6 %d %d %d", &w, &h, &max) != 3) || (w != HX8347_WIDTH) || (h != HX8347_HEIGHT) || (max != 255)
+			|| (fgetc(f) == EOF)) {
+		fclose(f);
+		return -1;
+	}
+	for (i = 0; i < HX8347_HEIGHT; i++) {
+		for (j = 0; j < HX8347_WIDTH; j++) {
+			if (fread(rgb, 1, 3, f) != 3) {
+				fclose(f);
+				return -1;
+			}
+			c = gram[i][j];
+			if ((rgb[0] != ((c >> 8) & 0xF8)) || (rgb[1] != ((c >> 3) & 0xFC)) || (rgb[2] != ((c << 3) & 0xF8))) {
+				diff++;
+			}
+		}
+	}
+	fclose(f);
+
+	return diff;
+}
+
+void HX8347Mock::begin(uint8_t dev) {
+	SPIMock::begin(dev);
+	start = 0;
+
+	return;
+}
+
+//one transaction: start byte, then register index (RS=0) or data (RS=1, RW=0/1)
+uint8_t HX8347Mock::transfer(uint8_t data) {
+	bytes++;
+	if (device != SPI_DEVICE_LCD) {
+		return 0;
+	}
+	if (start == 0) {
+		start = data;
+		return 0;
+	}
+	if (start == lcd_start) { //register index
+		index = data;
+		if (index == REG_GRAM) {
+			x = (regs[0x02] << 8) | regs[0x03];
+			y = (regs[0x06] << 8) | regs[0x07];
+			hi_valid = 0;
+		}
+	} else if (start == (lcd_start | 0x02)) { //write data
+		if (index != REG_GRAM) {
+			regs[index] = data;
+		} else if (!hi_valid) {
+			hi = data;
+			hi_valid = 1;
+		} else {
+			hi_valid = 0;
+			write_gram((hi << 8) | data);
+		}
+	} else if (start == (lcd_start | 0x03)) { //read data
+		return regs[index];
+	}
+
+	return 0;
+}
+
+//-------------------- Private --------------------
+
+void HX8347Mock::write_gram(uint16_t color) {
+	uint8_t mac = regs[REG_MEMORY_ACCESS];
+	uint16_t px, py;
+
+	if (mac & MV) {
+		px = y;
+		py = x;
+	} else {
+		px = x;
+		py = y;
+	}
+	if (mac & MX) {
+		px = (HX8347_WIDTH - 1) - px;
+	}
+	if (mac & MY) {
+		py = (HX8347_HEIGHT - 1) - py;
+	}
+	if ((px < HX8347_WIDTH) && (py < HX8347_HEIGHT)) {
+		gram[py][px] = color;
+	} else {
+		errors++;
+	}
+	pixels++;
+
+	//column first, then page, wraps inside the area
+	if (++x > ((regs[0x04] << 8) | regs[0x05])) {
+		x = (regs[0x02] << 8) | regs[0x03];
+		if (++y > ((regs[0x08] << 8) | regs[0x09])) {
+			y = (regs[0x06] << 8) | regs[0x07];
+		}
+	}
+
+	return;
+}
+
+#endif //SPI_MOCK
@@ -0,0 +1,66 @@
+#ifndef SPIMock_h
+#define SPIMock_h
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  #include <inttypes.h>
+#ifdef __cplusplus
+}
+#endif
+
+
+//Host builds with SPI_MOCK (SPIBus.h): the bus calls these instead of the SPI hardware
+class SPIMock
+{
+  public:
+    uint32_t bytes; //all devices
+    uint32_t transactions; //beginTransaction() calls
+
+    SPIMock(void) : bytes(0), transactions(0), device(0xFF) {}
+    virtual ~SPIMock(void) {}
+    virtual void begin(uint8_t dev) { device = dev; transactions++; } //device selected
+    virtual void end(void) { device = 0xFF; } //device deselected
+    virtual uint8_t transfer(uint8_t data) { bytes++; return 0; }
+
+  protected:
+    uint8_t device; //SPI_DEVICE_..., 0xFF = none
+};
+
+
+#define HX8347_WIDTH  (240) //panel, portrait
+#define HX8347_HEIGHT (320)
+
+//MI0283QT2 display model: register set, area window, GRAM and the orientation of register 0x16
+class HX8347Mock : public SPIMock
+{
+  public:
+    uint16_t gram[HX8347_HEIGHT][HX8347_WIDTH]; //RGB565 as seen on the panel
+    uint32_t pixels; //GRAM writes
+    uint16_t errors; //pixels outside of the panel
+
+    HX8347Mock(uint8_t id = 0); //LCD_ID of the MI0283QT2 constructor
+    void clear(uint16_t color); //gram and counters
+    void clearCounters(void);
+    uint8_t readRegister(uint8_t reg);
+    uint16_t getPixel(uint16_t x, uint16_t y); //panel coordinates
+    uint8_t savePPM(const char *file); //returns 0 if ok
+    int32_t comparePPM(const char *file); //number of differing pixels, -1 if the file can't be read
+
+    virtual void begin(uint8_t dev);
+    virtual uint8_t transfer(uint8_t data);
+
+  private:
+    uint8_t start; //start byte of the transaction, 0 = not yet received
+    uint8_t index; //register index
+    uint8_t hi, hi_valid; //first byte of a GRAM pixel
+    uint8_t regs[256];
+    uint16_t x, y; //GRAM address counter, logical
+    uint8_t lcd_start;
+
+    void write_gram(uint16_t color);
+};
+
+
+#endif //SPIMock_h
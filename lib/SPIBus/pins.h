@@ -0,0 +1,96 @@
+#ifndef pins_h
+#define pins_h
+
+
+//Board pins of the display (MI0283QT2) and touch controller (ADS7846) on the shared SPI bus.
+//All pins are constants, so digitalWriteFast() compiles to a single sbi/cbi instruction.
+//Define a pin before including this file to override the board default.
+//Software SPI: see SPIBus.h.
+
+#if (defined(__AVR_ATmega1280__) || \
+     defined(__AVR_ATmega1281__) || \
+     defined(__AVR_ATmega2560__) || \
+     defined(__AVR_ATmega2561__))      //--- Arduino Mega ---
+# define BOARD_LCD_LED_PIN   (9) //PH6: OC2B
+# define BOARD_LCD_RST_PIN   (8)
+# define BOARD_LCD_CS_PIN    (7)
+# define BOARD_TP_CS_PIN     (6)
+# if defined(SOFTWARE_SPI)
+#  define BOARD_MOSI_PIN     (11)
+#  define BOARD_MISO_PIN     (12)
+#  define BOARD_CLK_PIN      (13)
+# else
+#  define BOARD_MOSI_PIN     (51)
+#  define BOARD_MISO_PIN     (50)
+#  define BOARD_CLK_PIN      (52)
+# endif
+# define SS_PORTBIT          (0) //PB0
+
+#elif (defined(__AVR_ATmega644__) || \
+       defined(__AVR_ATmega644P__))    //--- Arduino 644 (www.mafu-foto.de) ---
+# define BOARD_LCD_LED_PIN   (3) //PB3: OC0
+# define BOARD_LCD_RST_PIN   (12)
+# define BOARD_LCD_CS_PIN    (13)
+# define BOARD_TP_CS_PIN     (14)
+# define BOARD_MOSI_PIN      (5)
+# define BOARD_MISO_PIN      (6)
+# define BOARD_CLK_PIN       (7)
+# define SS_PORTBIT          (4) //PB4
+# define USART_XCK_PIN       (0) //PB0: XCK0
+# define USART_TXD_PIN       (9) //PD1: TXD0
+
+#else                                  //--- Arduino Uno ---
+# define BOARD_LCD_LED_PIN   (9) //PB1: OC1
+# define BOARD_LCD_RST_PIN   (8)
+# define BOARD_LCD_CS_PIN    (7)
+# define BOARD_TP_CS_PIN     (6)
+# define BOARD_MOSI_PIN      (11)
+# define BOARD_MISO_PIN      (12)
+# define BOARD_CLK_PIN       (13)
+# define SS_PORTBIT          (2) //PB2
+# define USART_XCK_PIN       (4) //PD4: XCK0
+# define USART_TXD_PIN       (1) //PD1: TXD0
+
+#endif
+
+#ifndef LCD_LED_PIN
+# define LCD_LED_PIN         BOARD_LCD_LED_PIN
+#endif
+#ifndef LCD_RST_PIN
+# define LCD_RST_PIN         BOARD_LCD_RST_PIN
+#endif
+#ifndef LCD_CS_PIN
+# define LCD_CS_PIN          BOARD_LCD_CS_PIN //display with LCD_ID 0
+#endif
+//Max. two displays: LCD_ID is one bit of the start byte (ID pin of the MI0283QT2), there is one CS pin per ID.
+//#define LCD_CS1_PIN        (5) //second display with LCD_ID 1 (select only if needed, otherwise both share LCD_CS_PIN)
+#ifndef TP_CS_PIN
+# define TP_CS_PIN           BOARD_TP_CS_PIN
+#endif
+//#define TP_BUSY_PIN        (5)
+//#define TP_IRQ_PIN         (3)
+#ifndef MOSI_PIN
+# define MOSI_PIN            BOARD_MOSI_PIN
+#endif
+#ifndef MISO_PIN
+# define MISO_PIN            BOARD_MISO_PIN
+#endif
+#ifndef CLK_PIN
+# define CLK_PIN             BOARD_CLK_PIN
+#endif
+
+//SOFTWARE_SPI fills (SPIBus::writeRepeat()) toggle MOSI and CLK with writes to the PIN register,
+//interrupts may change other pins of that port meanwhile (no PORT read-modify-write).
+#define MOSI_HIGH()          digitalWriteFast(MOSI_PIN, HIGH)
+#define MOSI_LOW()           digitalWriteFast(MOSI_PIN, LOW)
+
+#define MISO_READ()          digitalReadFast(MISO_PIN)
+
+#define CLK_HIGH()           digitalWriteFast(CLK_PIN, HIGH)
+#define CLK_LOW()            digitalWriteFast(CLK_PIN, LOW)
+
+//SS has to be output or input with pull-up, otherwise the hardware SPI falls back to slave mode
+#define SS_PULLUP()          do { if (!(DDRB & (1 << SS_PORTBIT))) { PORTB |= (1 << SS_PORTBIT); } } while (0)
+
+
+#endif //pins_h
@@ -39,8 +39,8 @@ MI0283QT2 TouchButton::TFTDisplay;
 
 TouchButton * TouchButton::sListStart = NULL;
 uint8_t TouchButton::sDefaultTouchBorder = TOUCHBUTTON_DEFAULT_TOUCH_BORDER;
-uint16_t TouchButton::sDefaultButtonColor = TOUCHBUTTON_DEFAULT_COLOR;
-uint16_t TouchButton::sDefaultCaptionColor = TOUCHBUTTON_DEFAULT_CAPTION_COLOR;
+color_t TouchButton::sDefaultButtonColor = TOUCHBUTTON_DEFAULT_COLOR;
+color_t TouchButton::sDefaultCaptionColor = TOUCHBUTTON_DEFAULT_CAPTION_COLOR;
 
 TouchButton::~TouchButton() {
 	// makes no sense on Arduino
@@ -72,10 +72,10 @@ TouchButton::TouchButton() {
 void TouchButton::setDefaultTouchBorder(const uint8_t aDefaultTouchBorder) {
 	sDefaultTouchBorder = aDefaultTouchBorder;
 }
-void TouchButton::setDefaultButtonColor(const uint16_t aDefaultButtonColor) {
+void TouchButton::setDefaultButtonColor(const color_t aDefaultButtonColor) {
 	sDefaultButtonColor = aDefaultButtonColor;
 }
-void TouchButton::setDefaultCaptionColor(const uint16_t aDefaultCaptionColor) {
+void TouchButton::setDefaultCaptionColor(const color_t aDefaultCaptionColor) {
 	sDefaultCaptionColor = aDefaultCaptionColor;
 }
 
@@ -117,7 +117,7 @@ int8_t TouchButton::initSimpleButtonPGM(const uint16_t aPositionX, const uint16_
  */
 int8_t TouchButton::initButton(const uint16_t aPositionX, const uint16_t aPositionY, const uint8_t aWidthX,
 		const uint8_t aHeightY, const char * aCaption, const uint8_t aCaptionSize, const uint8_t aTouchBorder,
-		const uint16_t aButtonColor, const uint16_t aCaptionColor, const int16_t aValue,
+		const color_t aButtonColor, const color_t aCaptionColor, const int16_t aValue,
 		void(*aOnTouchHandler)(TouchButton * const, int16_t)) {
 
 	mWidth = aWidthX;
@@ -331,11 +331,11 @@ void TouchButton::setCaptionPGM(PGM_P aCaption) {
 /*
  * changes box color and redraws button
  */
-void TouchButton::setColor(const uint16_t aColor) {
+void TouchButton::setColor(const color_t aColor) {
 	mButtonColor = aColor;
 }
 
-void TouchButton::setCaptionColor(const uint16_t aColor) {
+void TouchButton::setCaptionColor(const color_t aColor) {
 	mCaptionColor = aColor;
 }
 
@@ -19,7 +19,7 @@
 
 #include <MI0283QT2.h>
 
-#define TOUCHBUTTON_DEFAULT_COLOR 			RGB( 180, 180, 180)
+#define TOUCHBUTTON_DEFAULT_COLOR 			COLOR_GRAY
 #define TOUCHBUTTON_DEFAULT_CAPTION_COLOR 	COLOR_BLACK
 #define TOUCHBUTTON_DEFAULT_TOUCH_BORDER 	2 // extension of touch region
 // Error codes
@@ -43,8 +43,8 @@ public:
 #endif
 
 	static void setDefaultTouchBorder(const uint8_t aDefaultTouchBorder);
-	static void setDefaultButtonColor(const uint16_t aDefaultButtonColor);
-	static void setDefaultCaptionColor(const uint16_t aDefaultCaptionColor);
+	static void setDefaultButtonColor(const color_t aDefaultButtonColor);
+	static void setDefaultCaptionColor(const color_t aDefaultCaptionColor);
 	static bool checkAllButtons(const uint16_t aTouchPositionX, const uint16_t aTouchPositionY);
 	static void activateAllButtons();
 	static void deactivateAllButtons();
@@ -57,16 +57,16 @@ public:
 			void(*aOnTouchHandler)(TouchButton * const, int16_t));
 	int8_t initButton(const uint16_t aPositionX, const uint16_t aPositionY, const uint8_t aWidthX,
 			const uint8_t aHeightY, const char *aCaption, const uint8_t aCaptionSize, const uint8_t aTouchBorder,
-			const uint16_t aButtonColor, const uint16_t aCaptionColor, const int16_t aValue,
+			const color_t aButtonColor, const color_t aCaptionColor, const int16_t aValue,
 			void (*aOnTouchHandler)(TouchButton* const, int16_t));
 	bool checkButton(const uint16_t aTouchPositionX, const uint16_t aTouchPositionY);
 	int8_t drawButton(void);
 	int8_t drawCaption(void);
 	int8_t setPosition(const uint16_t aPositionX, const uint16_t aPositionY);
-	void setColor(const uint16_t aColor);
+	void setColor(const color_t aColor);
 	void setCaption(const char *aCaption);
 	void setCaptionPGM(PGM_P aCaption);
-	void setCaptionColor(const uint16_t aColor);
+	void setCaptionColor(const color_t aColor);
 	void setValue(const int16_t aValue);
 	const char *getCaption(void) const;
 	uint16_t getPositionX(void) const;
@@ -83,12 +83,12 @@ private:
 	static MI0283QT2 TFTDisplay;
 #endif
 	static TouchButton *sListStart;
-	static uint16_t sDefaultButtonColor;
-	static uint16_t sDefaultCaptionColor;
+	static color_t sDefaultButtonColor;
+	static color_t sDefaultCaptionColor;
 	static uint8_t sDefaultTouchBorder;
 
-	uint16_t mButtonColor;
-	uint16_t mCaptionColor;
+	color_t mButtonColor;
+	color_t mCaptionColor;
 	uint16_t mPositionX;
 	uint16_t mPositionY;
 	uint8_t mWidth;
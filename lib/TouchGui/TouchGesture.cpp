@@ -0,0 +1,136 @@
+/*
+ * TouchGesture.cpp
+ *
+ * Gesture recognizer fed by TP_SAMPLE of ADS7846::getSample()
+ *
+ *      License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ *      Version: 1.0.0
+ *
+ * 	Usage:
+ * 		call update() once per loop with TouchPanel.getSample() after TouchPanel.service()
+ *
+ */
+
+#include "TouchGesture.h"
+
+TouchGesture::TouchGesture() {
+	mState = TOUCHGESTURE_STATE_IDLE;
+	mMoveThreshold = TOUCHGESTURE_DEFAULT_MOVE_THRESHOLD;
+	mMillisLongPress = TOUCHGESTURE_DEFAULT_MILLIS_LONG_PRESS;
+	mMillisDoubleTap = TOUCHGESTURE_DEFAULT_MILLIS_DOUBLE_TAP;
+	mSwipeMinDistance = TOUCHGESTURE_DEFAULT_SWIPE_MIN_DISTANCE;
+	mMillisSwipeMax = TOUCHGESTURE_DEFAULT_MILLIS_SWIPE_MAX;
+	mStartX = 0;
+	mStartY = 0;
+	mLastX = 0;
+	mLastY = 0;
+	mStartTime = 0;
+	mLastTapTime = 0;
+	mLastWasTap = false;
+}
+
+void TouchGesture::setThresholds(const uint8_t aMoveThreshold, const uint16_t aMillisLongPress,
+		const uint16_t aMillisDoubleTap, const uint16_t aSwipeMinDistance, const uint16_t aMillisSwipeMax) {
+	mMoveThreshold = aMoveThreshold;
+	mMillisLongPress = aMillisLongPress;
+	mMillisDoubleTap = aMillisDoubleTap;
+	mSwipeMinDistance = aSwipeMinDistance;
+	mMillisSwipeMax = aMillisSwipeMax;
+}
+
+/**
+ * Feed one sample, returns TOUCHGESTURE_NONE or one event
+ */
+uint8_t TouchGesture::update(const TP_SAMPLE * const aSample) {
+	uint8_t tEvent = TOUCHGESTURE_NONE;
+	int16_t tDeltaX = aSample->x - mStartX;
+	int16_t tDeltaY = aSample->y - mStartY;
+	uint16_t tAbsX = (tDeltaX < 0) ? -tDeltaX : tDeltaX;
+	uint16_t tAbsY = (tDeltaY < 0) ? -tDeltaY : tDeltaY;
+	// 16 bit difference is valid for 65 seconds
+	uint16_t tMillis = aSample->time - mStartTime;
+
+	switch (aSample->pen) {
+	case TP_PEN_DOWN:
+		mState = TOUCHGESTURE_STATE_PRESSED;
+		mStartX = aSample->x;
+		mStartY = aSample->y;
+		mStartTime = aSample->time;
+		break;
+
+	case TP_PEN_MOVE:
+		if (mState == TOUCHGESTURE_STATE_PRESSED) {
+			if (tAbsX > mMoveThreshold || tAbsY > mMoveThreshold) {
+				mState = TOUCHGESTURE_STATE_DRAGGING;
+				tEvent = TOUCHGESTURE_DRAG_START;
+			} else if (tMillis >= mMillisLongPress) {
+				mState = TOUCHGESTURE_STATE_LONG_PRESSED;
+				mLastWasTap = false;
+				tEvent = TOUCHGESTURE_LONG_PRESS;
+			}
+		} else if (mState == TOUCHGESTURE_STATE_DRAGGING) {
+			if (aSample->x != mLastX || aSample->y != mLastY) {
+				tEvent = TOUCHGESTURE_DRAG_MOVE;
+			}
+		}
+		break;
+
+	case TP_PEN_UP:
+		if (mState == TOUCHGESTURE_STATE_PRESSED) {
+			if (mLastWasTap && (uint16_t) (aSample->time - mLastTapTime) <= mMillisDoubleTap) {
+				// no triple tap
+				mLastWasTap = false;
+				tEvent = TOUCHGESTURE_DOUBLE_TAP;
+			} else {
+				mLastWasTap = true;
+				tEvent = TOUCHGESTURE_TAP;
+			}
+			mLastTapTime = aSample->time;
+		} else if (mState == TOUCHGESTURE_STATE_DRAGGING) {
+			mLastWasTap = false;
+			tEvent = TOUCHGESTURE_DRAG_END;
+			if (tMillis <= mMillisSwipeMax) {
+				// main axis decides the direction
+				if (tAbsX >= tAbsY) {
+					if (tAbsX >= mSwipeMinDistance) {
+						tEvent = (tDeltaX < 0) ? TOUCHGESTURE_SWIPE_LEFT : TOUCHGESTURE_SWIPE_RIGHT;
+					}
+				} else if (tAbsY >= mSwipeMinDistance) {
+					tEvent = (tDeltaY < 0) ? TOUCHGESTURE_SWIPE_UP : TOUCHGESTURE_SWIPE_DOWN;
+				}
+			}
+		}
+		mState = TOUCHGESTURE_STATE_IDLE;
+		break;
+
+	default:
+		break;
+	}
+	mLastX = aSample->x;
+	mLastY = aSample->y;
+	return tEvent;
+}
+
+bool TouchGesture::isDragging(void) {
+	return (mState == TOUCHGESTURE_STATE_DRAGGING);
+}
+
+uint8_t TouchGesture::getState(void) {
+	return mState;
+}
+
+uint16_t TouchGesture::getStartX(void) {
+	return mStartX;
+}
+
+uint16_t TouchGesture::getStartY(void) {
+	return mStartY;
+}
+
+int16_t TouchGesture::getDeltaX(void) {
+	return mLastX - mStartX;
+}
+
+int16_t TouchGesture::getDeltaY(void) {
+	return mLastY - mStartY;
+}
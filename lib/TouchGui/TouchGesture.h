@@ -0,0 +1,74 @@
+/*
+ * TouchGesture.h
+ *
+ * Gesture recognizer fed by TP_SAMPLE of ADS7846::getSample()
+ * emits tap, double tap, long press, drag start/move/end and swipe events
+ * integer math only, timing from the 16 bit sample time
+ *
+ *      License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ *      Version: 1.0.0
+ *
+ * 	Ram usage:
+ * 		23 byte per recognizer
+ *
+ */
+
+#ifndef TOUCHGESTURE_H_
+#define TOUCHGESTURE_H_
+
+#include <ADS7846.h>
+
+#define TOUCHGESTURE_DEFAULT_MOVE_THRESHOLD 		8 // pixel a touch may move and still be a tap / long press
+#define TOUCHGESTURE_DEFAULT_MILLIS_LONG_PRESS 		800
+#define TOUCHGESTURE_DEFAULT_MILLIS_DOUBLE_TAP 		300 // max time between release and second release
+#define TOUCHGESTURE_DEFAULT_SWIPE_MIN_DISTANCE 	60 // pixel on main axis
+#define TOUCHGESTURE_DEFAULT_MILLIS_SWIPE_MAX 		400 // max duration of a swipe
+
+// Events returned by update()
+#define TOUCHGESTURE_NONE 			0
+#define TOUCHGESTURE_TAP 			1 // released without moving
+#define TOUCHGESTURE_DOUBLE_TAP 	2 // second tap within double tap time (the first one was reported as TAP)
+#define TOUCHGESTURE_LONG_PRESS 	3 // held without moving, reported once, release gives no event
+#define TOUCHGESTURE_DRAG_START 	4 // moved more than move threshold
+#define TOUCHGESTURE_DRAG_MOVE 		5 // position changed while dragging
+#define TOUCHGESTURE_DRAG_END 		6 // released after drag (too slow or too short for a swipe)
+#define TOUCHGESTURE_SWIPE_LEFT 	7 // released after a fast drag, replaces DRAG_END
+#define TOUCHGESTURE_SWIPE_RIGHT 	8
+#define TOUCHGESTURE_SWIPE_UP 		9
+#define TOUCHGESTURE_SWIPE_DOWN 	10
+
+#define TOUCHGESTURE_STATE_IDLE 		0
+#define TOUCHGESTURE_STATE_PRESSED 		1
+#define TOUCHGESTURE_STATE_DRAGGING 	2
+#define TOUCHGESTURE_STATE_LONG_PRESSED 3
+
+class TouchGesture {
+public:
+	TouchGesture();
+	void setThresholds(const uint8_t aMoveThreshold, const uint16_t aMillisLongPress, const uint16_t aMillisDoubleTap,
+			const uint16_t aSwipeMinDistance, const uint16_t aMillisSwipeMax);
+	uint8_t update(const TP_SAMPLE * const aSample);
+	bool isDragging(void); // true from DRAG_START until release -> skip hit testing
+	uint8_t getState(void);
+	uint16_t getStartX(void);
+	uint16_t getStartY(void);
+	int16_t getDeltaX(void); // since touch start
+	int16_t getDeltaY(void);
+
+private:
+	uint8_t mState; // see TOUCHGESTURE_STATE_..
+	uint8_t mMoveThreshold;
+	uint16_t mMillisLongPress;
+	uint16_t mMillisDoubleTap;
+	uint16_t mSwipeMinDistance;
+	uint16_t mMillisSwipeMax;
+	uint16_t mStartX;
+	uint16_t mStartY;
+	uint16_t mLastX;
+	uint16_t mLastY;
+	uint16_t mStartTime;
+	uint16_t mLastTapTime;
+	bool mLastWasTap;
+};
+
+#endif /* TOUCHGESTURE_H_ */
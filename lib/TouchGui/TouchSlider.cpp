@@ -37,13 +37,13 @@ MI0283QT2 TouchSlider::TFTDisplay;
 #endif
 
 TouchSlider * TouchSlider::sListStart = NULL;
-uint16_t TouchSlider::sDefaultSliderColor = TOUCHSLIDER_DEFAULT_SLIDER_COLOR;
-uint16_t TouchSlider::sDefaultBarColor = TOUCHSLIDER_DEFAULT_BAR_COLOR;
-uint16_t TouchSlider::sDefaultBarThresholdColor = TOUCHSLIDER_DEFAULT_BAR_THRESHOLD_COLOR;
-uint16_t TouchSlider::sDefaultBarBackgroundColor = TOUCHSLIDER_DEFAULT_BAR_BACK_COLOR;
-uint16_t TouchSlider::sDefaultCaptionColor = TOUCHSLIDER_DEFAULT_CAPTION_COLOR;
-uint16_t TouchSlider::sDefaultValueColor = TOUCHSLIDER_DEFAULT_VALUE_COLOR;
-uint16_t TouchSlider::sDefaultValueCaptionBackgroundColor = TOUCHSLIDER_DEFAULT_CAPTION_VALUE_BACK_COLOR;
+color_t TouchSlider::sDefaultSliderColor = TOUCHSLIDER_DEFAULT_SLIDER_COLOR;
+color_t TouchSlider::sDefaultBarColor = TOUCHSLIDER_DEFAULT_BAR_COLOR;
+color_t TouchSlider::sDefaultBarThresholdColor = TOUCHSLIDER_DEFAULT_BAR_THRESHOLD_COLOR;
+color_t TouchSlider::sDefaultBarBackgroundColor = TOUCHSLIDER_DEFAULT_BAR_BACK_COLOR;
+color_t TouchSlider::sDefaultCaptionColor = TOUCHSLIDER_DEFAULT_CAPTION_COLOR;
+color_t TouchSlider::sDefaultValueColor = TOUCHSLIDER_DEFAULT_VALUE_COLOR;
+color_t TouchSlider::sDefaultValueCaptionBackgroundColor = TOUCHSLIDER_DEFAULT_CAPTION_VALUE_BACK_COLOR;
 
 int8_t TouchSlider::sDefaultTouchBorder = TOUCHSLIDER_DEFAULT_TOUCH_BORDER;
 
@@ -86,10 +86,10 @@ void TouchSlider::init(const MI0283QT2 aTheLCD) {
 /*
  * Static initialization of slider default colors
  */
-void TouchSlider::setDefaults(const int8_t aDefaultTouchBorder, const uint16_t aDefaultSliderColor,
-		const uint16_t aDefaultBarColor, const uint16_t aDefaultBarThresholdColor,
-		const uint16_t aDefaultBarBackgroundColor, const uint16_t aDefaultCaptionColor,
-		const uint16_t aDefaultValueColor, const uint16_t aDefaultValueCaptionBackgroundColor) {
+void TouchSlider::setDefaults(const int8_t aDefaultTouchBorder, const color_t aDefaultSliderColor,
+		const color_t aDefaultBarColor, const color_t aDefaultBarThresholdColor,
+		const color_t aDefaultBarBackgroundColor, const color_t aDefaultCaptionColor,
+		const color_t aDefaultValueColor, const color_t aDefaultValueCaptionBackgroundColor) {
 	sDefaultSliderColor = aDefaultSliderColor;
 	sDefaultBarColor = aDefaultBarColor;
 	sDefaultBarThresholdColor = aDefaultBarThresholdColor;
@@ -100,17 +100,17 @@ void TouchSlider::setDefaults(const int8_t aDefaultTouchBorder, const uint16_t a
 	sDefaultTouchBorder = aDefaultTouchBorder;
 }
 
-void TouchSlider::setDefaultSliderColor(const uint16_t aDefaultSliderColor) {
+void TouchSlider::setDefaultSliderColor(const color_t aDefaultSliderColor) {
 	sDefaultSliderColor = aDefaultSliderColor;
 }
 
-void TouchSlider::setDefaultBarColor(const uint16_t aDefaultBarColor) {
+void TouchSlider::setDefaultBarColor(const color_t aDefaultBarColor) {
 	sDefaultBarColor = aDefaultBarColor;
 }
 
-void TouchSlider::initSliderColors(const uint16_t aSliderColor, const uint16_t aBarColor,
-		const uint16_t aBarThresholdColor, const uint16_t aBarBackgroundColor, const uint16_t aCaptionColor,
-		const uint16_t aValueColor, const uint16_t aValueCaptionBackgroundColor) {
+void TouchSlider::initSliderColors(const color_t aSliderColor, const color_t aBarColor,
+		const color_t aBarThresholdColor, const color_t aBarBackgroundColor, const color_t aCaptionColor,
+		const color_t aValueColor, const color_t aValueCaptionBackgroundColor) {
 	mSliderColor = aSliderColor;
 	mBarColor = aBarColor;
 	mBarThresholdColor = aBarThresholdColor;
@@ -266,7 +266,7 @@ void TouchSlider::drawBar() {
 
 // Draw value bar
 	if (mActualValue > 0) {
-		uint16_t tColor = mBarColor;
+		color_t tColor = mBarColor;
 		if (mActualValue > mThresholdValue) {
 			tColor = mBarThresholdColor;
 		}
@@ -325,7 +325,6 @@ int8_t TouchSlider::printValue() {
 	if (!mShowValue) {
 		return 0;
 	}
-	const char * pValueAsString;
 	uint16_t tValuePositionY;
 	if (mCaption != NULL) {
 		tValuePositionY = mPositionYBottom + mSize + FONT_HEIGHT;
@@ -339,15 +338,13 @@ int8_t TouchSlider::printValue() {
 		return TOUCHSLIDER_ERROR_VALUE_TOO_HIGH;
 	}
 	if (mValueHandler == NULL) {
-		char tValueAsString[4];
-		pValueAsString = &tValueAsString[0];
-		sprintf(tValueAsString, "%03u", mActualValue);
+		TFTDisplay.drawInteger(mPositionX, tValuePositionY, mActualValue, DEC, 3, '0', 1, mValueColor,
+				mValueCaptionBackgroundColor);
 	} else {
 		// mValueHandler has to provide the char array
-		pValueAsString = mValueHandler(mActualValue);
+		TFTDisplay.drawText(mPositionX, tValuePositionY, (char *) mValueHandler(mActualValue), 1, mValueColor,
+				mValueCaptionBackgroundColor);
 	}
-	TFTDisplay.drawText(mPositionX, tValuePositionY, (char *) pValueAsString, 1, mValueColor,
-			mValueCaptionBackgroundColor);
 	return 0;
 }
 
@@ -494,15 +491,15 @@ int8_t TouchSlider::checkParameterValues() {
 	return tRetValue;
 }
 
-void TouchSlider::setBarThresholdColor(uint16_t barThresholdColor) {
+void TouchSlider::setBarThresholdColor(color_t barThresholdColor) {
 	mBarThresholdColor = barThresholdColor;
 }
 
-void TouchSlider::setSliderColor(uint16_t sliderColor) {
+void TouchSlider::setSliderColor(color_t sliderColor) {
 	mSliderColor = sliderColor;
 }
 
-void TouchSlider::setBarColor(uint16_t barColor) {
+void TouchSlider::setBarColor(color_t barColor) {
 	mBarColor = barColor;
 }
 
@@ -16,7 +16,7 @@
 
 #include <MI0283QT2.h>
 
-#define TOUCHSLIDER_DEFAULT_SLIDER_COLOR 		RGB( 180, 180, 180)
+#define TOUCHSLIDER_DEFAULT_SLIDER_COLOR 		COLOR_GRAY
 #define TOUCHSLIDER_DEFAULT_BAR_COLOR 			COLOR_GREEN
 #define TOUCHSLIDER_DEFAULT_BAR_THRESHOLD_COLOR COLOR_RED
 #define TOUCHSLIDER_DEFAULT_BAR_BACK_COLOR 		COLOR_WHITE
@@ -63,12 +63,12 @@ public:
 #ifndef TOUCHGUI_SAVE_SPACE
 	static void init(const MI0283QT2 aTheLCD);
 #endif
-	static void setDefaults(const int8_t aDefaultTouchBorder, const uint16_t aDefaultSliderColor,
-			const uint16_t aDefaultBarColor, const uint16_t aDefaultBarThresholdColor,
-			const uint16_t aDefaultBarBackgroundColor, const uint16_t aDefaultCaptionColor,
-			const uint16_t aDefaultValueColor, const uint16_t aDefaultValueCaptionBackgroundColor);
-	static void setDefaultSliderColor(const uint16_t aDefaultSliderColor);
-	static void setDefaultBarColor(const uint16_t aDefaultBarColor);
+	static void setDefaults(const int8_t aDefaultTouchBorder, const color_t aDefaultSliderColor,
+			const color_t aDefaultBarColor, const color_t aDefaultBarThresholdColor,
+			const color_t aDefaultBarBackgroundColor, const color_t aDefaultCaptionColor,
+			const color_t aDefaultValueColor, const color_t aDefaultValueCaptionBackgroundColor);
+	static void setDefaultSliderColor(const color_t aDefaultSliderColor);
+	static void setDefaultBarColor(const color_t aDefaultBarColor);
 	static bool checkAllSliders(const uint16_t aTouchPositionX, const uint16_t aTouchPositionY);
 	static void deactivateAllSliders();
 	static void activateAllSliders();
@@ -82,9 +82,9 @@ public:
 			const uint8_t aMaxValue, const bool aShowBorder, const char * aCaption, const uint8_t aInitalValue,
 			const uint8_t aThresholdValue, const bool aShowValue, const int8_t aTouchBorder,
 			uint8_t (*aOnChangeHandler)(TouchSlider * const, const uint8_t), const char * (*aValueHandler)(uint8_t));
-	void initSliderColors(const uint16_t aSliderColor, const uint16_t aBarColor, const uint16_t aBarThresholdColor,
-			const uint16_t aBarBackgroundColor, const uint16_t aCaptionColor, const uint16_t aValueColor,
-			const uint16_t aValueCaptionBackgroundColor);
+	void initSliderColors(const color_t aSliderColor, const color_t aBarColor, const color_t aBarThresholdColor,
+			const color_t aBarBackgroundColor, const color_t aCaptionColor, const color_t aValueColor,
+			const color_t aValueCaptionBackgroundColor);
 	int8_t drawSlider();
 	bool checkSlider(const uint16_t aPositionX, const uint16_t aPositionY);
 	void drawBar();
@@ -95,10 +95,10 @@ public:
 	uint16_t getPositionYBottom() const;
 	void activate();
 	void deactivate();
-	uint16_t getBarColor() const;
-	void setSliderColor(uint16_t sliderColor);
-	void setBarColor(uint16_t barColor);
-	void setBarThresholdColor(uint16_t barThresholdColor);
+	color_t getBarColor() const;
+	void setSliderColor(color_t sliderColor);
+	void setBarColor(color_t barColor);
+	void setBarThresholdColor(color_t barThresholdColor);
 
 private:
 #ifndef TOUCHGUI_SAVE_SPACE
@@ -107,13 +107,13 @@ private:
 	/*
 	 * Defaults
 	 */
-	static uint16_t sDefaultSliderColor;
-	static uint16_t sDefaultBarColor;
-	static uint16_t sDefaultBarThresholdColor;
-	static uint16_t sDefaultBarBackgroundColor;
-	static uint16_t sDefaultCaptionColor;
-	static uint16_t sDefaultValueColor;
-	static uint16_t sDefaultValueCaptionBackgroundColor;
+	static color_t sDefaultSliderColor;
+	static color_t sDefaultBarColor;
+	static color_t sDefaultBarThresholdColor;
+	static color_t sDefaultBarBackgroundColor;
+	static color_t sDefaultCaptionColor;
+	static color_t sDefaultValueColor;
+	static color_t sDefaultValueCaptionBackgroundColor;
 	static int8_t sDefaultTouchBorder;
 	/*
 	 * The Value
@@ -136,13 +136,13 @@ private:
 	bool mShowValue;
 	uint8_t mTouchBorder;// extension of touch region
 	// Colors
-	uint16_t mSliderColor;
-	uint16_t mBarColor;
-	uint16_t mBarThresholdColor;
-	uint16_t mBarBackgroundColor;
-	uint16_t mCaptionColor;
-	uint16_t mValueColor;
-	uint16_t mValueCaptionBackgroundColor;
+	color_t mSliderColor;
+	color_t mBarColor;
+	color_t mBarThresholdColor;
+	color_t mBarBackgroundColor;
+	color_t mCaptionColor;
+	color_t mValueColor;
+	color_t mValueCaptionBackgroundColor;
 	// misc
 	bool mIsActive;
 	TouchSlider* mNextObject;
@@ -0,0 +1,185 @@
+/*
+ * TouchStroke.cpp
+ *
+ * Stroke engine for painting with TP_SAMPLE of ADS7846::getSample()
+ *
+ *      License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ *      Version: 1.0.0
+ *
+ * 	Usage:
+ * 		call update() for every sample of the paint area (pen up included to end the stroke)
+ *
+ */
+
+#include <stdlib.h>
+#include "TouchStroke.h"
+
+#ifndef TOUCHGUI_SAVE_SPACE
+MI0283QT2 TouchStroke::TFTDisplay;
+#endif
+
+TouchStroke::TouchStroke() {
+	mTime = 0;
+	mFrameMillis = 0;
+	mCount = 0;
+	mRadius = 0;
+	mColor = COLOR_BLACK;
+}
+
+#ifndef TOUCHGUI_SAVE_SPACE
+void TouchStroke::init(const MI0283QT2 aTheLCD) {
+	TFTDisplay = aTheLCD;
+}
+#endif
+
+/**
+ * @param aRadius 0 = 1 pixel line
+ */
+void TouchStroke::setBrush(const uint8_t aRadius, const color_t aColor) {
+	mRadius = aRadius;
+	mColor = aColor;
+}
+
+uint8_t TouchStroke::getBrushRadius(void) {
+	return mRadius;
+}
+
+color_t TouchStroke::getBrushColor(void) {
+	return mColor;
+}
+
+void TouchStroke::update(const TP_SAMPLE * const aSample) {
+	int16_t tX, tY, tPredictedX, tPredictedY;
+	uint16_t tMillis, tRatio;
+
+	if (aSample->pen != TP_PEN_DOWN && aSample->pen != TP_PEN_MOVE) {
+		// end of stroke
+		mCount = 0;
+		return;
+	}
+	tX = aSample->x;
+	tY = aSample->y;
+	if (aSample->pen == TP_PEN_DOWN || mCount == 0) {
+		// start with a dot
+		for (uint8_t i = 0; i < 3; ++i) {
+			mX[i] = tX;
+			mY[i] = tY;
+		}
+		mTime = aSample->time;
+		mFrameMillis = 0;
+		mCount = 1;
+		drawPiece(tX, tY, tX, tY);
+		return;
+	}
+	if (tX == mX[2] && tY == mY[2]) {
+		return;
+	}
+
+	tMillis = aSample->time - mTime;
+	mTime = aSample->time;
+	if (tMillis == 0) {
+		tMillis = 1;
+	}
+	if (tMillis <= TOUCHSTROKE_MAX_FRAME_MILLIS) {
+		if (mFrameMillis == 0) {
+			mFrameMillis = tMillis;
+		} else {
+			mFrameMillis = ((3 * mFrameMillis) + tMillis + 2) / 4;
+		}
+	}
+
+	mX[0] = mX[1];
+	mY[0] = mY[1];
+	mX[1] = mX[2];
+	mY[1] = mY[2];
+	mX[2] = tX;
+	mY[2] = tY;
+	if (mCount < 3) {
+		mCount++;
+	}
+
+	/*
+	 * predict next sample: last velocity for one smoothed sample interval
+	 * ratio = interval / time of last segment * 16
+	 */
+	tRatio = (mFrameMillis * 16) / tMillis;
+	if (tRatio > TOUCHSTROKE_MAX_PREDICTION) {
+		tRatio = TOUCHSTROKE_MAX_PREDICTION;
+	}
+	tPredictedX = tX + ((((tX - mX[1]) * (int16_t) tRatio) + 8) >> 4);
+	tPredictedY = tY + ((((tY - mY[1]) * (int16_t) tRatio) + 8) >> 4);
+	drawSpline(tPredictedX, tPredictedY);
+}
+
+/**
+ * Catmull-Rom segment from mX[1] to mX[2] with mX[0] and predicted point as outer control points.
+ * Positions relative to mX[1], t in 0..64:
+ * P(t) = ((D * t + C) * t + B) * t / 2 with B = P2 - P0, C = 2 * P0 + 4 * P2 - P3, D = -P0 - 3 * P2 + P3
+ */
+void TouchStroke::drawSpline(const int16_t aPredictedX, const int16_t aPredictedY) {
+	int16_t tAX = mX[0] - mX[1];
+	int16_t tAY = mY[0] - mY[1];
+	int16_t tCX = mX[2] - mX[1];
+	int16_t tCY = mY[2] - mY[1];
+	int16_t tEX = aPredictedX - mX[1];
+	int16_t tEY = aPredictedY - mY[1];
+	int16_t tLastX = mX[1];
+	int16_t tLastY = mY[1];
+	int16_t tX, tY;
+	int32_t tBX, tBY, tCCX, tCCY, tDX, tDY, tValue;
+	uint8_t tPieces, tT;
+
+	if (abs(tAX) > TOUCHSTROKE_MAX_SPLINE_DELTA || abs(tAY) > TOUCHSTROKE_MAX_SPLINE_DELTA
+			|| abs(tCX) > TOUCHSTROKE_MAX_SPLINE_DELTA || abs(tCY) > TOUCHSTROKE_MAX_SPLINE_DELTA
+			|| abs(tEX) > TOUCHSTROKE_MAX_SPLINE_DELTA || abs(tEY) > TOUCHSTROKE_MAX_SPLINE_DELTA) {
+		drawPiece(mX[1], mY[1], mX[2], mY[2]);
+		return;
+	}
+
+	// number of pieces from the longer axis
+	tPieces = ((abs(tCX) > abs(tCY)) ? abs(tCX) : abs(tCY)) / TOUCHSTROKE_PIECE_LENGTH;
+	if (tPieces == 0) {
+		tPieces = 1;
+	} else if (tPieces > TOUCHSTROKE_MAX_PIECES) {
+		tPieces = TOUCHSTROKE_MAX_PIECES;
+	}
+
+	tBX = tCX - tAX;
+	tBY = tCY - tAY;
+	tCCX = (2 * tAX) + (4 * tCX) - tEX;
+	tCCY = (2 * tAY) + (4 * tCY) - tEY;
+	tDX = tEX - tAX - (3 * tCX);
+	tDY = tEY - tAY - (3 * tCY);
+
+	for (uint8_t i = 1; i < tPieces; ++i) {
+		tT = (i * 64) / tPieces;
+		// result * 2^19, max. 1e9 for deltas <= 255
+		tValue = (((tDX * tT) + (tCCX * 64)) * tT + (tBX * 4096)) * tT;
+		tX = mX[1] + (int16_t) ((tValue + 0x40000L) >> 19);
+		tValue = (((tDY * tT) + (tCCY * 64)) * tT + (tBY * 4096)) * tT;
+		tY = mY[1] + (int16_t) ((tValue + 0x40000L) >> 19);
+		drawPiece(tLastX, tLastY, tX, tY);
+		tLastX = tX;
+		tLastY = tY;
+	}
+	drawPiece(tLastX, tLastY, mX[2], mY[2]);
+}
+
+void TouchStroke::drawPiece(int16_t aX0, int16_t aY0, int16_t aX1, int16_t aY1) {
+	if (mRadius == 0) {
+		// drawLine() takes unsigned positions, the spline may overshoot the border
+		if (aX0 < 0) {
+			aX0 = 0;
+		}
+		if (aY0 < 0) {
+			aY0 = 0;
+		}
+		if (aX1 < 0) {
+			aX1 = 0;
+		}
+		if (aY1 < 0) {
+			aY1 = 0;
+		}
+	}
+	TFTDisplay.fillCapsule(aX0, aY0, aX1, aY1, mRadius, mColor);
+}
@@ -0,0 +1,62 @@
+/*
+ * TouchStroke.h
+ *
+ * Stroke engine for painting with TP_SAMPLE of ADS7846::getSample()
+ * Samples are connected with a Catmull-Rom spline (fixed point) instead of straight lines.
+ * The newest segment is drawn as soon as its sample arrives, the missing next point
+ * is predicted one sample interval ahead from the velocity (sample timestamps).
+ * Brush radius > 0 renders every spline piece as capsule (MI0283QT2::fillCapsule()).
+ *
+ *      License: GPL v3 (http://www.gnu.org/licenses/gpl.html)
+ *      Version: 1.0.0
+ *
+ * 	Ram usage:
+ * 		20 byte per stroke
+ *
+ */
+
+#ifndef TOUCHSTROKE_H_
+#define TOUCHSTROKE_H_
+
+#include "TouchGui.h"
+
+#include <MI0283QT2.h>
+#include <ADS7846.h>
+
+#define TOUCHSTROKE_PIECE_LENGTH 		4 // pixel per straight piece of the spline
+#define TOUCHSTROKE_MAX_PIECES 			16
+#define TOUCHSTROKE_MAX_SPLINE_DELTA 	255 // larger jumps are drawn straight (keeps spline math in 32 bit)
+#define TOUCHSTROKE_MAX_FRAME_MILLIS 	100 // longer sample intervals are pauses, not used for prediction
+#define TOUCHSTROKE_MAX_PREDICTION 		32 // max. prediction as multiple of the last segment * 16
+
+#ifdef TOUCHGUI_SAVE_SPACE
+extern MI0283QT2 TFTDisplay;
+#endif
+
+class TouchStroke {
+public:
+	TouchStroke();
+#ifndef TOUCHGUI_SAVE_SPACE
+	static void init(const MI0283QT2 aTheLCD);
+#endif
+	void setBrush(const uint8_t aRadius, const color_t aColor);
+	uint8_t getBrushRadius(void);
+	color_t getBrushColor(void);
+	void update(const TP_SAMPLE * const aSample);
+
+private:
+#ifndef TOUCHGUI_SAVE_SPACE
+	static MI0283QT2 TFTDisplay;
+#endif
+	void drawSpline(const int16_t aPredictedX, const int16_t aPredictedY);
+	void drawPiece(int16_t aX0, int16_t aY0, int16_t aX1, int16_t aY1);
+	int16_t mX[3]; // last samples of the stroke, [2] is the newest
+	int16_t mY[3];
+	uint16_t mTime; // of newest sample
+	uint16_t mFrameMillis; // smoothed sample interval
+	uint8_t mCount; // samples in mX/mY, 0 = no stroke
+	uint8_t mRadius;
+	color_t mColor;
+};
+
+#endif /* TOUCHSTROKE_H_ */
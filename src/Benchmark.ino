@@ -0,0 +1,141 @@
+/*
+ * Benchmark.ino
+ *
+ *      Cycles per call of the MI0283QT2 primitives, printed as CSV on the serial port:
+ *      case,param,calls,cycles
+ *
+ *      Runs on the board or without one under simavr (the display is not needed, nothing is read back):
+ *      tools/benchmark.sh run Benchmark.elf > new.csv
+ *      tools/benchmark.sh compare old.csv new.csv
+ *
+ *      Timer1 runs at Fcpu as cycle counter, the backlight PWM (Timer1 on Uno) is switched off.
+ *
+ */
+
+#include <Arduino.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include <MI0283QT2.h>
+
+#define BENCHMARK_CLOCK 2 //spi-clk = Fcpu/2
+
+MI0283QT2 TFTDisplay;
+
+volatile uint16_t Timer1Overflows;
+
+ISR(TIMER1_OVF_vect) {
+	Timer1Overflows++;
+}
+
+/*
+ * Timer1 with prescaler 1 and overflow counter
+ */
+void startCycleCounter(void) {
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TCNT1 = 0;
+	Timer1Overflows = 0;
+	TIFR1 = (1 << TOV1);
+	TIMSK1 = (1 << TOIE1);
+	TCCR1B = (1 << CS10);
+}
+
+uint32_t getCycles(void) {
+	uint16_t tLow, tHigh;
+	uint8_t tSREG = SREG;
+
+	cli();
+	tLow = TCNT1;
+	tHigh = Timer1Overflows;
+	if ((TIFR1 & (1 << TOV1)) && (tLow < 0x8000)) {
+		tHigh++; //overflow not yet handled
+	}
+	SREG = tSREG;
+	return ((uint32_t) tHigh << 16) | tLow;
+}
+
+void printPGM(const char * aString) {
+	char c;
+
+	while ((c = pgm_read_byte(aString++)) != 0) {
+		Serial.write(c);
+	}
+}
+
+void printResult(const char * aName, uint16_t aParam, uint16_t aCalls, uint32_t aCycles) {
+	printPGM(aName);
+	Serial.write(',');
+	Serial.print(aParam);
+	Serial.write(',');
+	Serial.print(aCalls);
+	Serial.write(',');
+	Serial.println(aCycles / aCalls);
+}
+
+/*
+ * runs aCode aCalls times and prints the cycles per call
+ */
+#define BENCHMARK(aName, aParam, aCalls, aCode) \
+	do { \
+		uint16_t tCall; \
+		uint32_t tStart = getCycles(); \
+		for (tCall = 0; tCall < (aCalls); tCall++) { \
+			aCode; \
+		} \
+		printResult(PSTR(aName), (aParam), (aCalls), getCycles() - tStart); \
+	} while (0)
+
+void setup() {
+	Serial.begin(115200);
+	TFTDisplay.init(BENCHMARK_CLOCK);
+	startCycleCounter();
+	sei();
+
+	printPGM(PSTR("case,param,calls,cycles\n"));
+
+	BENCHMARK("clear", 0, 2, TFTDisplay.clear(COLOR_WHITE));
+
+	BENCHMARK("fillRect", 1, 100, TFTDisplay.fillRect(10, 10, 10, 10, COLOR_RED));
+	BENCHMARK("fillRect", 10, 50, TFTDisplay.fillRect(10, 10, 19, 19, COLOR_RED));
+	BENCHMARK("fillRect", 50, 10, TFTDisplay.fillRect(10, 10, 59, 59, COLOR_RED));
+	BENCHMARK("fillRect", 100, 5, TFTDisplay.fillRect(10, 10, 109, 109, COLOR_RED));
+	BENCHMARK("fillRect", 200, 2, TFTDisplay.fillRect(10, 10, 209, 209, COLOR_RED));
+
+	BENCHMARK("drawPixel", 0, 100, TFTDisplay.drawPixel(tCall & 0xFF, 120, COLOR_BLUE));
+
+	// param = slope in degrees
+	BENCHMARK("drawLine", 0, 20, TFTDisplay.drawLine(0, 100, 319, 100, COLOR_BLUE));
+	BENCHMARK("drawLine", 14, 20, TFTDisplay.drawLine(0, 40, 319, 120, COLOR_BLUE));
+	BENCHMARK("drawLine", 45, 20, TFTDisplay.drawLine(0, 0, 239, 239, COLOR_BLUE));
+	BENCHMARK("drawLine", 76, 20, TFTDisplay.drawLine(100, 0, 160, 239, COLOR_BLUE));
+	BENCHMARK("drawLine", 90, 20, TFTDisplay.drawLine(200, 0, 200, 239, COLOR_BLUE));
+
+	// param = size
+	BENCHMARK("drawChar", 1, 50, TFTDisplay.drawChar(10, 10, 'W', 1, COLOR_BLACK, COLOR_WHITE));
+	BENCHMARK("drawChar", 2, 50, TFTDisplay.drawChar(10, 10, 'W', 2, COLOR_BLACK, COLOR_WHITE));
+	BENCHMARK("drawCharTransparent", 1, 50, TFTDisplay.drawChar(10, 10, 'W', 1, COLOR_BLACK, COLOR_BLACK));
+
+	// param = length
+	BENCHMARK("drawText", 1, 20, TFTDisplay.drawText(10, 30, (char *) "A", 1, COLOR_BLACK, COLOR_WHITE));
+	BENCHMARK("drawText", 10, 20, TFTDisplay.drawText(10, 30, (char *) "0123456789", 1, COLOR_BLACK, COLOR_WHITE));
+	BENCHMARK("drawText", 39, 10,
+			TFTDisplay.drawText(0, 30, (char *) "The quick brown fox jumps over the lazy", 1, COLOR_BLACK, COLOR_WHITE));
+	BENCHMARK("drawTextPGM", 10, 20,
+			TFTDisplay.drawTextPGM(10, 50, PSTR("0123456789"), 1, COLOR_BLACK, COLOR_WHITE));
+
+	BENCHMARK("drawCircle", 50, 10, TFTDisplay.drawCircle(160, 120, 50, COLOR_GREEN));
+	BENCHMARK("fillCircle", 50, 5, TFTDisplay.fillCircle(160, 120, 50, COLOR_GREEN));
+
+	printPGM(PSTR("done\n"));
+	Serial.flush();
+
+	// simavr quits on sleep with interrupts disabled
+	cli();
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sleep_cpu();
+}
+
+void loop() {
+}
@@ -11,6 +11,25 @@ uint16_t generation = 0;
 uint16_t drawcolor[5] = { RGB( 15, 15, 15), RGB(255,255, 0), RGB( 0, 0, 0), RGB( 40, 40, 0), RGB(100,100, 0) };
 uint8_t frame[GOL_X_SIZE][GOL_Y_SIZE];
 
+#if defined(LCD_PALETTE)
+//color_t is a palette index: drawcolor[] and GEN_COLOR are loaded to the palette entries after the default colors
+#define GOL_PALETTE_FIRST (7)
+#define GOL_COLOR(c)      (GOL_PALETTE_FIRST + (c))
+#define GOL_GEN_COLOR     (GOL_PALETTE_FIRST + 5)
+
+static void load_colors(MI0283QT2 &lcd) {
+	uint8_t i;
+
+	for (i = 0; i < 5; i++) {
+		lcd.setPaletteColor(GOL_COLOR(i), drawcolor[i]);
+	}
+	lcd.setPaletteColor(GOL_GEN_COLOR, GEN_COLOR);
+}
+#else
+#define GOL_COLOR(c)      (drawcolor[c])
+#define GOL_GEN_COLOR     GEN_COLOR
+#endif
+
 uint8_t alive(uint8_t x, uint8_t y) {
 	if ((x < GOL_X_SIZE) && (y < GOL_Y_SIZE)) {
 		if ((frame[x][y] == ON_CELL) || (frame[x][y] == NEW_CELL)) {
@@ -83,6 +102,10 @@ void draw_gol(MI0283QT2 lcd) {
 	uint8_t c, x, y, color = 0;
 	uint16_t px, py;
 
+#if defined(LCD_PALETTE)
+	load_colors(lcd);
+#endif
+
 	for (x = 0, px = 0; x < GOL_X_SIZE; x++) {
 		for (y = 0, py = 0; y < GOL_Y_SIZE; y++) {
 			c = frame[x][y];
@@ -101,7 +124,7 @@ void draw_gol(MI0283QT2 lcd) {
 					color = DIE2_COLOR;
 				}
 				lcd.fillRect(px + 1, py + 1, px + (lcd.getWidth() / GOL_X_SIZE) - 2,
-						py + (lcd.getHeight() / GOL_Y_SIZE) - 2, drawcolor[color]);
+						py + (lcd.getHeight() / GOL_Y_SIZE) - 2, GOL_COLOR(color));
 			}
 			py += (lcd.getHeight() / GOL_Y_SIZE);
 		}
@@ -163,10 +186,13 @@ void init_gol(MI0283QT2 lcd) {
 
 //  draw_gol(lcd);
 	//redraw cells
+#if defined(LCD_PALETTE)
+	load_colors(lcd);
+#endif
 	for (x = 0, px = 0; x < GOL_X_SIZE; x++) {
 		for (y = 0, py = 0; y < GOL_Y_SIZE; y++) {
 			lcd.fillRect(px + 1, py + 1, px + (lcd.getWidth() / GOL_X_SIZE) - 2,
-					py + (lcd.getHeight() / GOL_Y_SIZE) - 2, drawcolor[DEAD_COLOR]);
+					py + (lcd.getHeight() / GOL_Y_SIZE) - 2, GOL_COLOR(DEAD_COLOR));
 			py += (lcd.getHeight() / GOL_Y_SIZE);
 		}
 		px += (lcd.getWidth() / GOL_X_SIZE);
@@ -176,6 +202,6 @@ void init_gol(MI0283QT2 lcd) {
 void drawGenerationText(MI0283QT2 lcd) {
 	uint16_t x;
 	//draw current generation
-	x = lcd.drawText(0, 0, (char*) "Gen.", 1, RGB(50,50,50), drawcolor[DEAD_COLOR]);
-	lcd.drawInteger(x, 0, (int) generation, 10, 1, RGB(50,50,50), drawcolor[DEAD_COLOR]);
+	x = lcd.drawText(0, 0, (char*) "Gen.", 1, GOL_GEN_COLOR, GOL_COLOR(DEAD_COLOR));
+	lcd.drawInteger(x, 0, (int) generation, 10, 1, GOL_GEN_COLOR, GOL_COLOR(DEAD_COLOR));
 }
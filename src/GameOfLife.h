@@ -15,6 +15,7 @@
 #define DEAD_COLOR  (2)
 #define DIE1_COLOR  (3)
 #define DIE2_COLOR  (4)
+#define GEN_COLOR   RGB(50,50,50) //generation text
 
 #define GOL_MAX_GEN (1000) //max generations
 #define GOL_X_SIZE   (20)
@@ -24,6 +25,8 @@
 #define ON_CELL  (0xAA)
 #define NEW_CELL (0xFF)
 
+extern uint16_t drawcolor[5]; //RGB565, index: ..._COLOR
+
 void init_gol(MI0283QT2 lcd);
 void play_gol(MI0283QT2 lcd);
 void draw_gol(MI0283QT2 lcd);
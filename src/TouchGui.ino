@@ -39,8 +39,12 @@
 #include <TouchButton.h>
 #include <TouchButtonAutorepeat.h>
 #include <TouchSlider.h>
+#include <TouchGesture.h>
+#include <TouchStroke.h>
 #include "GameOfLife.h"
 #include <Chart.h>
+#include <Profiler.h>
+#include <MemoryMonitor.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,7 +59,7 @@ extern "C" {
 
 #ifdef DEBUG
 TouchButton TouchButtonDebug;
-void doDebug(TouchButton * const aTheTouchedButton, int aValue);
+void doDebug(TouchButton * const aTheTouchedButton, int16_t aValue);
 #endif
 
 /*
@@ -63,7 +67,9 @@ void doDebug(TouchButton * const aTheTouchedButton, int aValue);
  */
 #define TP_EEPROMADDR (E2END -1 - sizeof(CAL_MATRIX)) //eeprom address for calibration data - 28 bytes
 ADS7846 TouchPanel;
-void printTPData(void);
+void printTPData(const TP_SAMPLE * aSample);
+TouchGesture Gesture;
+bool GuiTouchedAtStart = false; // hit testing is skipped while dragging outside of buttons and sliders
 
 MI0283QT2 TFTDisplay;
 #define DISPLAY_HEIGHT 240
@@ -80,7 +86,7 @@ unsigned long LoopMillis = 0;
 void createButtonsAndSliders(void);
 
 // Global button handler
-void doButtons(TouchButton * const aTheTochedButton, int aValue);
+void doButtons(TouchButton * const aTheTochedButton, int16_t aValue);
 
 //Global slider handler
 uint8_t doSliders(TouchSlider * const aTheTochedSlider, uint8_t aSliderValue);
@@ -89,15 +95,17 @@ uint8_t doSliders(TouchSlider * const aTheTochedSlider, uint8_t aSliderValue);
  * Draw stuff
  */
 TouchButton TouchButtonDraw;
-void doDraw(TouchButton * const aTheTouchedButton, int aValue);
-void drawLine(const bool aNewStart, unsigned int color);
+void doDraw(TouchButton * const aTheTouchedButton, int16_t aValue);
+TouchStroke Stroke;
+#define DRAW_BRUSH_COUNT 4
+const uint8_t DrawBrushes[DRAW_BRUSH_COUNT] = { 0, 1, 3, 6 }; // radius, long press selects the next one
+uint8_t DrawBrushIndex = 0;
 
 TouchButton TouchButtonClear_Continue;
 
 TouchButton TouchButtonDrawColor[5];
-const uint16_t DrawColors[5] = { COLOR_BLACK, COLOR_RED, COLOR_GREEN, COLOR_BLUE, COLOR_YELLOW };
-void doDrawColor(TouchButton * const aTheTouchedButton, int aValue);
-unsigned int DrawColor = COLOR_BLACK;
+const color_t DrawColors[5] = { COLOR_BLACK, COLOR_RED, COLOR_GREEN, COLOR_BLUE, COLOR_YELLOW };
+void doDrawColor(TouchButton * const aTheTouchedButton, int16_t aValue);
 
 /*
  * Game of life stuff
@@ -106,12 +114,12 @@ void showGolSettings(void);
 
 TouchButton TouchButtonGolDying;
 TouchSlider TouchSliderGolDying;
-void doGolDying(TouchButton * const aTheTouchedButton, int aValue);
+void doGolDying(TouchButton * const aTheTouchedButton, int16_t aValue);
 void syncronizeGolSliderAndButton(void);
 const char * mapValueGol(uint8_t aValue);
 
 TouchButton TouchButtonNew;
-void doClearAndNewContinue(TouchButton * const aTheTouchedButton, int aValue);
+void doClearAndNewContinue(TouchButton * const aTheTouchedButton, int16_t aValue);
 void initNewGameOfLife(void);
 
 TouchSlider TouchSliderGolSpeed;
@@ -124,7 +132,6 @@ bool GolRunning = false;
 bool GolInitialized = false;
 #define GOL_DIE_THRESHOLD 5
 #define GOL_DIE_MAX 20
-extern unsigned int drawcolor[5]; // see gameOfLife.ino
 
 /**
  * Menu stuff
@@ -168,7 +175,7 @@ uint8_t BacklightValue = 60;
 
 TouchButtonAutorepeat TouchButtonAutorepeatBacklightIncrease;
 TouchButtonAutorepeat TouchButtonAutorepeatBacklightDecrease;
-void doChangeBacklight(TouchButton * const aTheTouchedButton, int aValue);
+void doChangeBacklight(TouchButton * const aTheTouchedButton, int16_t aValue);
 
 TouchSlider TouchSliderDemo1;
 TouchSlider TouchSliderAction;
@@ -208,23 +215,50 @@ void setRTCTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t dayOfWeek, uint8
 // a string buffer for any purpose...
 char StringBuffer[128];
 
+#ifdef DEBUG
+/*
+ * static RAM per subsystem for MemoryMonitor::dump()
+ */
+const char sMemoryLcd[] PROGMEM = "LCD";
+const char sMemoryTouch[] PROGMEM = "TP";
+const char sMemoryButtons[] PROGMEM = "TB";
+const char sMemorySliders[] PROGMEM = "TS";
+const char sMemoryChart[] PROGMEM = "CH";
+const char sMemoryGol[] PROGMEM = "GOL";
+const char sMemoryBuffer[] PROGMEM = "Buf";
+const MEMORY_SUBSYSTEM MemorySubsystems[] PROGMEM = {
+	{ sMemoryLcd, sizeof TFTDisplay },
+	{ sMemoryTouch, sizeof TouchPanel + sizeof Gesture + sizeof Stroke },
+	{ sMemoryButtons, (11 * sizeof(TouchButton)) + sizeof TouchButtonDrawColor + (2 * sizeof(TouchButtonAutorepeat)) },
+	{ sMemorySliders, 6 * sizeof(TouchSlider) },
+	{ sMemoryChart, sizeof ChartExample },
+	{ sMemoryGol, GOL_X_SIZE * GOL_Y_SIZE },
+	{ sMemoryBuffer, sizeof StringBuffer }
+};
+#endif
+
 void setup() {
 
 	//Serial.begin(115200);
-	//init display
-	TFTDisplay.init(4); //spi-clk = Fcpu/4
+	//init display, initStart() holds the reset while the touch controller is set up
+	TFTDisplay.initStart(4); //spi-clk = Fcpu/4
 
 	//init touch controller
 	TouchPanel.init();
 
-	//touch-panel calibration
-	TouchPanel.service();
-	if (TouchPanel.getPressure() > 5) {
+	//touch-panel calibration needed?
+	//read directly: service() reports the first reading after pen-down as not pressed (TP_DROP_FIRST)
+	bool tCalibrate = (TouchPanel.readPressure() > 5) || !TouchPanel.readCalibration(TP_EEPROMADDR);
+
+	//wait for the rest of the init sequence
+	while (TFTDisplay.initService()) {
+		;
+	}
+
+	if (tCalibrate) {
 		//clear screen
 		TFTDisplay.clear(COLOR_WHITE);
 		TouchPanel.doCalibration(&TFTDisplay, TP_EEPROMADDR, 0); //dont check EEPROM for calibration data
-	} else {
-		TouchPanel.doCalibration(&TFTDisplay, TP_EEPROMADDR, 1); //check EEPROM for calibration data
 	}
 
 #ifndef TOUCH_SAVE_SPACE
@@ -253,10 +287,15 @@ void setup() {
 
 void loop() {
 	bool tGuiTouched = false;
+	PROFILER_LOOP();
 
 	//service routine for touch panel
 	// get tp values
+	PROFILER_SECTION(PROFILER_TOUCH);
 	TouchPanel.service();
+	const TP_SAMPLE * tSample = TouchPanel.getSample();
+	uint8_t tGesture = Gesture.update(tSample);
+	PROFILER_SECTION(PROFILER_IDLE);
 
 	// count milliseconds for loop control
 	unsigned long tMillis = millis();
@@ -264,18 +303,27 @@ void loop() {
 	LastMillis = tMillis;
 
 	//touch press?
-	if (TouchPanel.getPressure() > 6) {
+	if (tSample->pen == TP_PEN_DOWN || tSample->pen == TP_PEN_MOVE) {
+		// true only for the first sample of a touch
+		StartNewTouch = (tSample->pen == TP_PEN_DOWN);
 		if (mActualApplication == APPLICATION_MENU || mActualApplication == APPLICATION_DRAW) {
-			printTPData();
+			printTPData(tSample);
 		}
 
 		/*
 		 * check if button or slider is touched
 		 */
-		tGuiTouched = TouchButton::checkAllButtons(TouchPanel.getX(), TouchPanel.getY());
-		if (!tGuiTouched) {
-			tGuiTouched = TouchSlider::checkAllSliders(TouchPanel.getX(), TouchPanel.getY());
+		PROFILER_SECTION(PROFILER_HIT);
+		if (StartNewTouch || GuiTouchedAtStart || !Gesture.isDragging()) {
+			tGuiTouched = TouchButton::checkAllButtons(tSample->x, tSample->y);
+			if (!tGuiTouched) {
+				tGuiTouched = TouchSlider::checkAllSliders(tSample->x, tSample->y);
+			}
+			if (StartNewTouch) {
+				GuiTouchedAtStart = tGuiTouched;
+			}
 		}
+		PROFILER_SECTION(PROFILER_DRAW);
 
 		if (!tGuiTouched) {
 			/**
@@ -283,8 +331,11 @@ void loop() {
 			 */
 			switch (mActualApplication) {
 			case APPLICATION_DRAW:
-				//draw line
-				drawLine(StartNewTouch, DrawColor);
+				if (tGesture == TOUCHGESTURE_LONG_PRESS) {
+					DrawBrushIndex = (DrawBrushIndex + 1) % DRAW_BRUSH_COUNT;
+					Stroke.setBrush(DrawBrushes[DrawBrushIndex], Stroke.getBrushColor());
+				}
+				Stroke.update(tSample);
 				break;
 			case APPLICATION_GAME_OF_LIFE:
 				if (GolRunning) {
@@ -294,14 +345,18 @@ void loop() {
 			}
 		}
 
-		StartNewTouch = false;
-
 	} else {
 		/**
 		 * no touch here
 		 * switch for different "apps"
 		 */
+		PROFILER_SECTION(PROFILER_DRAW);
 		switch (mActualApplication) {
+		case APPLICATION_DRAW:
+			// end of stroke
+			Stroke.update(tSample);
+			break;
+
 		case APPLICATION_SETTINGS:
 			// Moving slider bar :-)
 			if (LoopMillis >= 20) {
@@ -332,7 +387,6 @@ void loop() {
 			}
 			break;
 		}
-		StartNewTouch = true;
 	} // touch press?
 
 	/*
@@ -351,7 +405,7 @@ void loop() {
 		}
 	}
 #endif
-
+	PROFILER_SECTION(PROFILER_IDLE);
 }
 
 /*
@@ -463,7 +517,7 @@ uint8_t doSliders(TouchSlider * const aTheTouchedSlider, uint8_t aSliderValue) {
 	return aSliderValue;
 }
 
-void doButtons(TouchButton * const aTheTouchedButton, int aValue) {
+void doButtons(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	TouchButton::deactivateAllButtons();
 	TouchSlider::deactivateAllSliders();
 	if (aTheTouchedButton == &TouchButtonChart) {
@@ -527,7 +581,7 @@ uint8_t doBacklight(TouchSlider * const aTheTouchedSlider, const uint8_t aBright
 	return (aBrightness / 5) * 5;
 }
 
-void doChangeBacklight(TouchButton * const aTheTouchedButton, int aValue) {
+void doChangeBacklight(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	BacklightValue += aValue;
 	checkBacklightValue();
 	TouchSliderBacklight.setActualValue(BacklightValue);
@@ -535,8 +589,13 @@ void doChangeBacklight(TouchButton * const aTheTouchedButton, int aValue) {
 }
 
 const char * mapBacklightPowerValue(uint8_t aBrightness) {
-	sprintf(StringBuffer, "%03u", BacklightValue);
-	return StringBuffer;
+	// 3 digits with leading zeros, the slider draws the returned string
+	static char tValueString[4];
+	tValueString[0] = '0' + (BacklightValue / 100);
+	tValueString[1] = '0' + ((BacklightValue / 10) % 10);
+	tValueString[2] = '0' + (BacklightValue % 10);
+	tValueString[3] = '\0';
+	return tValueString;
 }
 
 // value map function for game of life speed slider
@@ -559,7 +618,7 @@ const char * mapValueGol(uint8_t aValue) {
 	return "fast   ";
 }
 
-void doGolDying(TouchButton * const aTheTouchedButton, int aValue) {
+void doGolDying(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	/*
 	 * GolDying button pressed
 	 */
@@ -590,7 +649,7 @@ void showGolSettings(void) {
 	TouchButtonClear_Continue.drawButton();
 }
 
-void doClearAndNewContinue(TouchButton * const aTheTouchedButton, int aValue) {
+void doClearAndNewContinue(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	if (mActualApplication == APPLICATION_DRAW) {
 		doDraw(aTheTouchedButton, aValue);
 		return;
@@ -611,16 +670,16 @@ void doClearAndNewContinue(TouchButton * const aTheTouchedButton, int aValue) {
 void initNewGameOfLife(void) {
 	GolInitialized = true;
 	init_gol(TFTDisplay);
-	drawcolor[0] = BACKGROUND_COLOR;
+	drawcolor[0] = COLOR_TO_RGB565(BACKGROUND_COLOR);
 	if (!GolShowDying) {
 		// change colors
-		drawcolor[2] = BACKGROUND_COLOR;
-		drawcolor[3] = BACKGROUND_COLOR;
-		drawcolor[4] = BACKGROUND_COLOR;
+		drawcolor[2] = COLOR_TO_RGB565(BACKGROUND_COLOR);
+		drawcolor[3] = COLOR_TO_RGB565(BACKGROUND_COLOR);
+		drawcolor[4] = COLOR_TO_RGB565(BACKGROUND_COLOR);
 	}
 }
 
-void doDraw(TouchButton * const aTheTouchedButton, int aValue) {
+void doDraw(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	/*
 	 * Draw button pressed
 	 */
@@ -635,22 +694,24 @@ void doDraw(TouchButton * const aTheTouchedButton, int aValue) {
 	mActualApplication = APPLICATION_DRAW;
 }
 
-void doDrawColor(TouchButton * const aTheTouchedButton, int aIndex) {
-	DrawColor = DrawColors[aIndex];
+void doDrawColor(TouchButton * const aTheTouchedButton, int16_t aIndex) {
+	Stroke.setBrush(DrawBrushes[DrawBrushIndex], DrawColors[aIndex]);
 }
 
 #ifdef DEBUG
-void doDebug(TouchButton * const aTheTouchedButton, int aValue) {
+void doDebug(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	/*
 	 * Debug button pressed
 	 */
-	uint8_t * stackptr = (uint8_t *) malloc(4); // use stackptr temporarily
-	uint8_t * heapptr = stackptr;// save value of heap pointer
-	free(stackptr);
-	stackptr = (uint8_t *) (SP);
-	sprintf(StringBuffer, "TB=%02u TS=%02u CH=%02u Stack=%04u Heap=%04u", sizeof *aTheTouchedButton,
-			sizeof TouchSliderBacklight, sizeof ChartExample, (unsigned int) stackptr, (unsigned int) heapptr);
-	TFTDisplay.drawText(1, DISPLAY_HEIGHT - (3 * FONT_HEIGHT) - 1, StringBuffer, 1, COLOR_BLACK, BACKGROUND_COLOR);
+	const uint16_t tYPos = DISPLAY_HEIGHT - (3 * (FONT_HEIGHT + 1));
+	// RAM usage and min. free stack since startup
+	TFTDisplay.setCursor(1, tYPos);
+	MemoryMonitor::dump(&TFTDisplay, MemorySubsystems, sizeof MemorySubsystems / sizeof MemorySubsystems[0]);
+#ifdef LOOP_PROFILE
+	// time per loop section since last debug button press
+	Profiler::draw(&TFTDisplay, 1, tYPos + (2 * (FONT_HEIGHT + 1)), COLOR_BLACK, BACKGROUND_COLOR);
+	Profiler::reset();
+#endif
 }
 #endif
 
@@ -778,21 +839,18 @@ void syncronizeGolSliderAndButton(void) {
 }
 
 //show touchpanel data
-void printTPData(void) {
-	sprintf(StringBuffer, "X:%03i|%04i Y:%03i|%04i P:%03i", TouchPanel.getX(), TouchPanel.getXraw(), TouchPanel.getY(),
-			TouchPanel.getYraw(), TouchPanel.getPressure());
-	TFTDisplay.drawText(20, 2, StringBuffer, 1, COLOR_BLACK, BACKGROUND_COLOR);
-}
-
-void drawLine(const bool aNewStart, unsigned int color) {
-	static unsigned int last_x = 0, last_y = 0;
-	if (aNewStart) {
-		TFTDisplay.drawPixel(TouchPanel.getX(), TouchPanel.getY(), color);
-	} else {
-		TFTDisplay.drawLine(last_x, last_y, TouchPanel.getX(), TouchPanel.getY(), color);
-	}
-	last_x = TouchPanel.getX();
-	last_y = TouchPanel.getY();
+void printTPData(const TP_SAMPLE * aSample) {
+	uint16_t tXPos;
+	tXPos = TFTDisplay.drawTextPGM(20, 2, PSTR("X:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->x, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, 2, '|', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->x_raw, DEC, 4, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawTextPGM(tXPos, 2, PSTR(" Y:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->y, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, 2, '|', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->y_raw, DEC, 4, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawTextPGM(tXPos, 2, PSTR(" P:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	TFTDisplay.drawInteger(tXPos, 2, aSample->pressure, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
 }
 
 void ADS7846DisplayChannels(void) {
@@ -800,8 +858,7 @@ void ADS7846DisplayChannels(void) {
 	int16_t tTemp;
 	for (uint8_t i = 0; i < 8; ++i) {
 		tTemp = TouchPanel.readChannel(ADS7846Channels[i], 32);
-		sprintf(StringBuffer, "%04u", tTemp);
-		TFTDisplay.drawText(15, tPosY, StringBuffer, 2, COLOR_RED, BACKGROUND_COLOR);
+		TFTDisplay.drawInteger(15, tPosY, (unsigned int) tTemp, DEC, 4, '0', 2, COLOR_RED, BACKGROUND_COLOR);
 		tPosY += FONT_HEIGHT * 2;
 	}
 }
@@ -836,9 +893,19 @@ void showRTCTime(void) {
 	i2c_stop();
 
 //buf[3] is day of week
-	sprintf_P(StringBuffer, PSTR("%02i.%02i.%04i %02i:%02i:%02i"), RtcBuf[4], RtcBuf[5], RtcBuf[6] + 2000, RtcBuf[2],
-			RtcBuf[1], RtcBuf[0]);
-	TFTDisplay.drawText(10, DISPLAY_HEIGHT - FONT_HEIGHT - 1, StringBuffer, 1, COLOR_RED, BACKGROUND_COLOR);
+	uint16_t tXPos;
+	const uint16_t tYPos = DISPLAY_HEIGHT - FONT_HEIGHT - 1;
+	tXPos = TFTDisplay.drawInteger(10, tYPos, RtcBuf[4], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, '.', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[5], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, '.', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[6] + 2000, DEC, 4, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ' ', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[2], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ':', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[1], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ':', 1, COLOR_RED, BACKGROUND_COLOR);
+	TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[0], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
 }
 
 void setRTCTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t dayOfWeek, uint8_t day, uint8_t month, uint16_t year) {
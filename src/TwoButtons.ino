@@ -45,7 +45,7 @@ void setRTCTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t dayOfWeek, uint8
  */
 #define TP_EEPROMADDR (E2END -1 - sizeof(CAL_MATRIX)) //eeprom address for calibration data - 28 bytes
 #ifdef DEBUG
-void printTPData(void);
+void printTPData(const TP_SAMPLE * aSample);
 #endif
 void printRGB(const uint16_t aColor, const uint16_t aXPos, const uint16_t aYPos);
 
@@ -60,48 +60,63 @@ bool StartNewTouch = true;
  * Loop control
  */
 
-// a string buffer for any purpose...
-char StringBuffer[128];
-
 #define BUTTON_WIDTH 180
 #define BUTTON_HEIGHT 50
 #define BUTTON_SPACING 30
 
+// the buttons change RGB565 values, the value of a button is its actual color
 #define CAPTION_COLOR_INCREMENT RGB(0x08,0x20,0x60)
 #define BUTTON_BACKGROUND_COLOR_INCREMENT RGB(0x08,0x10,0x40)
+#define START_COLOR RGB(0,0,255)
+#if defined(LCD_PALETTE)
+// color_t is a palette index: the changed colors are palette entries after the default colors
+#define CAPTION_COLOR 7
+#define BUTTON_BACKGROUND_COLOR 8
+#else
+#define CAPTION_COLOR START_COLOR
+#define BUTTON_BACKGROUND_COLOR START_COLOR
+#endif
 TouchButtonAutorepeat TouchButtonCaptionAutorepeat;
 TouchButton TouchButtonBackground;
 
 // Callback touch handler
-void doButtons(TouchButton * const aTheTochedButton, int aValue);
+void doButtons(TouchButton * const aTheTochedButton, int16_t aValue);
 
 void setup() {
 
 	//Serial.begin(115200);
-	//init display
-	TFTDisplay.init(4); //spi-clk = Fcpu/4
-	TFTDisplay.clear(BACKGROUND_COLOR);
+	//init display, initStart() holds the reset while the touch controller is set up
+	TFTDisplay.initStart(4); //spi-clk = Fcpu/4
 
 	//init touch controller
 	TouchPanel.init();
-	//touch-panel calibration
-	TouchPanel.service();
-	if (TouchPanel.getPressure() > 5) {
-		//clear screen
+	//touch-panel calibration needed?
+	//read directly: service() reports the first reading after pen-down as not pressed (TP_DROP_FIRST)
+	bool tCalibrate = (TouchPanel.readPressure() > 5) || !TouchPanel.readCalibration(TP_EEPROMADDR);
+
+	//wait for the rest of the init sequence
+	while (TFTDisplay.initService()) {
+		;
+	}
+#if defined(LCD_PALETTE)
+	TFTDisplay.setPaletteColor(CAPTION_COLOR, START_COLOR);
+	TFTDisplay.setPaletteColor(BUTTON_BACKGROUND_COLOR, START_COLOR);
+#endif
+	TFTDisplay.clear(BACKGROUND_COLOR);
+
+	if (tCalibrate) {
 		TouchPanel.doCalibration(&TFTDisplay, TP_EEPROMADDR, 0); //dont check EEPROM for calibration data
-	} else {
-		TouchPanel.doCalibration(&TFTDisplay, TP_EEPROMADDR, 1); //check EEPROM for calibration data
 	}
 
 	// Create  2 buttons
 	int8_t tErrorValue = 0;
 	tErrorValue += TouchButtonCaptionAutorepeat.initButton(20, 20, BUTTON_WIDTH, BUTTON_HEIGHT, "Caption", 2,
-			TOUCHBUTTON_DEFAULT_TOUCH_BORDER, TOUCHBUTTON_DEFAULT_COLOR, COLOR_BLUE, COLOR_BLUE, &doButtons);
+			TOUCHBUTTON_DEFAULT_TOUCH_BORDER, TOUCHBUTTON_DEFAULT_COLOR, CAPTION_COLOR, START_COLOR, &doButtons);
 	TouchButtonCaptionAutorepeat.setButtonAutorepeatTiming(1000, 200, 23000, 50, &StartNewTouch);
 	tErrorValue += TouchButtonBackground.initButton(20,
 			TouchButtonCaptionAutorepeat.getPositionYBottom() + BUTTON_SPACING, BUTTON_WIDTH, BUTTON_HEIGHT,
-			"Background", 2, TOUCHBUTTON_DEFAULT_TOUCH_BORDER, COLOR_BLUE, TOUCHBUTTON_DEFAULT_CAPTION_COLOR,
-			COLOR_BLUE, &doButtons);
+			"Background", 2, TOUCHBUTTON_DEFAULT_TOUCH_BORDER, BUTTON_BACKGROUND_COLOR, TOUCHBUTTON_DEFAULT_CAPTION_COLOR,
+			START_COLOR, &doButtons);
 	TouchButtonCaptionAutorepeat.drawButton();
 	TouchButtonBackground.drawButton();
 
@@ -125,39 +140,47 @@ void loop() {
 
 	//service routine for touch panel
 	TouchPanel.service();
+	const TP_SAMPLE * tSample = TouchPanel.getSample();
 #ifdef DEBUG
-	printTPData();
+	printTPData(tSample);
 #endif
 	//touch press?
-	if (TouchPanel.getPressure() > 6) {
+	if (tSample->pen == TP_PEN_DOWN || tSample->pen == TP_PEN_MOVE) {
+		// true only for the first sample of a touch
+		StartNewTouch = (tSample->pen == TP_PEN_DOWN);
 		/*
 		 * check if button is touched
 		 */
-		tGuiTouched = TouchButton::checkAllButtons(TouchPanel.getX(), TouchPanel.getY());
+		tGuiTouched = TouchButton::checkAllButtons(tSample->x, tSample->y);
 		if (tGuiTouched) {
-//			printTPData();
+//			printTPData(tSample);
 		}
-		StartNewTouch = false;
-	} else {
-		StartNewTouch = true;
 	}
 #ifdef RTC_EXISTS
 	showRTCTime();
 #endif
 }
 
-void doButtons(TouchButton * const aTheTouchedButton, int aValue) {
+void doButtons(TouchButton * const aTheTouchedButton, int16_t aValue) {
 	printRGB(aValue, 10, 200);
 	if (aTheTouchedButton == &TouchButtonCaptionAutorepeat) {
 		aValue += CAPTION_COLOR_INCREMENT;
+#if defined(LCD_PALETTE)
+		TFTDisplay.setPaletteColor(CAPTION_COLOR, aValue);
+#else
 		aTheTouchedButton->setCaptionColor(aValue);
+#endif
 		aTheTouchedButton->setValue(aValue);
 		aTheTouchedButton->drawCaption();
 		return;
 	}
 	if (aTheTouchedButton == &TouchButtonBackground && StartNewTouch) {
 		aValue += BUTTON_BACKGROUND_COLOR_INCREMENT;
+#if defined(LCD_PALETTE)
+		TFTDisplay.setPaletteColor(BUTTON_BACKGROUND_COLOR, aValue);
+#else
 		aTheTouchedButton->setColor(aValue);
+#endif
 		aTheTouchedButton->setValue(aValue);
 		aTheTouchedButton->drawButton();
 		return;
@@ -168,24 +191,32 @@ void doButtons(TouchButton * const aTheTouchedButton, int aValue) {
 //show rgb data of touched button
 void printRGB(const uint16_t aColor, uint16_t aXPos, const uint16_t aYPos) {
 	//RED
-	sprintf(StringBuffer, "R=%02X", (aColor & 0xF800) >> 8);
-	aXPos = TFTDisplay.drawText(aXPos, aYPos, StringBuffer, 2, COLOR_RED, BACKGROUND_COLOR);
+	aXPos = TFTDisplay.drawTextPGM(aXPos, aYPos, PSTR("R="), 2, COLOR_RED, BACKGROUND_COLOR);
+	aXPos = TFTDisplay.drawInteger(aXPos, aYPos, (aColor & 0xF800) >> 8, HEX, 2, '0', 2, COLOR_RED, BACKGROUND_COLOR);
 	//GREEN
-	sprintf(StringBuffer, "G=%02X", (aColor & 0x07E0) >> 3);
 	aXPos += 2 * FONT_WIDTH;
-	aXPos = TFTDisplay.drawText(aXPos, aYPos, StringBuffer, 2, COLOR_GREEN, BACKGROUND_COLOR);
+	aXPos = TFTDisplay.drawTextPGM(aXPos, aYPos, PSTR("G="), 2, COLOR_GREEN, BACKGROUND_COLOR);
+	aXPos = TFTDisplay.drawInteger(aXPos, aYPos, (aColor & 0x07E0) >> 3, HEX, 2, '0', 2, COLOR_GREEN, BACKGROUND_COLOR);
 	//BLUE
-	sprintf(StringBuffer, "B=%02X", (aColor & 0x001F) << 3);
 	aXPos += 2 * FONT_WIDTH;
-	TFTDisplay.drawText(aXPos, aYPos, StringBuffer, 2, COLOR_BLUE, BACKGROUND_COLOR);
+	aXPos = TFTDisplay.drawTextPGM(aXPos, aYPos, PSTR("B="), 2, COLOR_BLUE, BACKGROUND_COLOR);
+	TFTDisplay.drawInteger(aXPos, aYPos, (aColor & 0x001F) << 3, HEX, 2, '0', 2, COLOR_BLUE, BACKGROUND_COLOR);
 }
 
 #ifdef DEBUG
 //show touchpanel data
-void printTPData(void) {
-	sprintf(StringBuffer, "X:%03i|%04i Y:%03i|%04i P:%03i", TouchPanel.getX(), TouchPanel.getXraw(), TouchPanel.getY(),
-			TouchPanel.getYraw(), TouchPanel.getPressure());
-	TFTDisplay.drawText(20, 2, StringBuffer, 1, COLOR_BLACK, BACKGROUND_COLOR);
+void printTPData(const TP_SAMPLE * aSample) {
+	uint16_t tXPos;
+	tXPos = TFTDisplay.drawTextPGM(20, 2, PSTR("X:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->x, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, 2, '|', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->x_raw, DEC, 4, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawTextPGM(tXPos, 2, PSTR(" Y:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->y, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, 2, '|', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, 2, aSample->y_raw, DEC, 4, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawTextPGM(tXPos, 2, PSTR(" P:"), 1, COLOR_BLACK, BACKGROUND_COLOR);
+	TFTDisplay.drawInteger(tXPos, 2, aSample->pressure, DEC, 3, '0', 1, COLOR_BLACK, BACKGROUND_COLOR);
 }
 #endif
 
@@ -220,9 +251,19 @@ void showRTCTime(void) {
 	i2c_stop();
 
 	//buf[3] is day of week
-	sprintf_P(StringBuffer, PSTR("%02i.%02i.%04i %02i:%02i:%02i"), RtcBuf[4], RtcBuf[5], RtcBuf[6] + 2000, RtcBuf[2],
-			RtcBuf[1], RtcBuf[0]);
-	TFTDisplay.drawText(10, DISPLAY_HEIGHT - FONT_HEIGHT - 1, StringBuffer, 1, COLOR_RED, BACKGROUND_COLOR);
+	uint16_t tXPos;
+	const uint16_t tYPos = DISPLAY_HEIGHT - FONT_HEIGHT - 1;
+	tXPos = TFTDisplay.drawInteger(10, tYPos, RtcBuf[4], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, '.', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[5], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, '.', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[6] + 2000, DEC, 4, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ' ', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[2], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ':', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[1], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
+	tXPos = TFTDisplay.drawChar(tXPos, tYPos, ':', 1, COLOR_RED, BACKGROUND_COLOR);
+	TFTDisplay.drawInteger(tXPos, tYPos, RtcBuf[0], DEC, 2, '0', 1, COLOR_RED, BACKGROUND_COLOR);
 }
 
 void setRTCTime(uint8_t sec, uint8_t min, uint8_t hour, uint8_t dayOfWeek, uint8_t day, uint8_t month, uint16_t year) {
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Runs src/Benchmark.ino under simavr and compares two results.
+#
+# benchmark.sh run Benchmark.elf > new.csv
+# benchmark.sh compare old.csv new.csv [percent]   exit code 1 if a case is slower by more than percent (default 5)
+
+case "$1" in
+run)
+	# simavr prints the UART output, keep the CSV lines only
+	simavr -m atmega328p -f 16000000 "$2" 2>&1 | tr -d '\r' | grep -E '^(case,|[A-Za-z]+,[0-9]+,[0-9]+,[0-9]+$|done$)'
+	;;
+compare)
+	awk -F, -v limit="${4:-5}" '
+		FNR == 1 || $1 == "done" { next }
+		FNR == NR { old[$1 "," $2] = $4; next }
+		{
+			key = $1 "," $2
+			if (!(key in old)) { printf "%-24s %10s %10d  new\n", key, "-", $4; next }
+			diff = (old[key] > 0) ? (($4 - old[key]) * 100.0 / old[key]) : 0
+			flag = (diff > limit) ? "  REGRESSION" : ""
+			if (flag != "") { failed = 1 }
+			printf "%-24s %10d %10d %+7.1f%%%s\n", key, old[key], $4, diff, flag
+		}
+		END { exit failed }
+	' "$2" "$3"
+	;;
+*)
+	echo "usage: $0 run <elf> | compare <old.csv> <new.csv> [percent]" >&2
+	exit 2
+	;;
+esac
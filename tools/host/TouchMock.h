@@ -0,0 +1,85 @@
+#ifndef TouchMock_h
+#define TouchMock_h
+
+
+//Host build (tools/host): ADS7846 model for the replay and sketch tests, the touches of a scripted session
+
+#include <Arduino.h>
+#include <SPIBus.h>
+#include <ADS7846.h>
+
+//raw position of a screen position with touch_calibration(): screen = (raw - 100) / 2.5 and (raw - 100) / 3.33
+#define TOUCH_RAW_X(x) (100 + ((x) * 5) / 2)
+#define TOUCH_RAW_Y(y) (100 + ((y) * 10) / 3)
+
+typedef struct
+{
+  uint16_t start, end; //ms
+  uint16_t x0, y0, x1, y1; //raw pos, moves from 0 to 1
+  uint8_t pressure;
+} TOUCH;
+
+//answers the Z1, Z2, X and Y commands of the ADS7846 library
+class TouchMock : public SPIMock
+{
+  public:
+    TouchMock(const TOUCH *session, uint8_t count) : session(session), count(count), cmd(0), bits(0), x(0), y(0), pressure(0) {}
+
+    void set(uint16_t ms) {
+      uint8_t i;
+
+      pressure = 0;
+      for (i = 0; i < count; i++) {
+        if ((ms >= session[i].start) && (ms < session[i].end)) {
+          x = session[i].x0 + ((long) (session[i].x1 - session[i].x0) * (ms - session[i].start)) / (session[i].end - session[i].start);
+          y = session[i].y0 + ((long) (session[i].y1 - session[i].y0) * (ms - session[i].start)) / (session[i].end - session[i].start);
+          pressure = session[i].pressure;
+        }
+      }
+    }
+
+    virtual uint8_t transfer(uint8_t data) {
+      uint16_t v;
+
+      bytes++;
+      if (device != SPI_DEVICE_TP) {
+        return 0;
+      }
+      if (data & CMD_START) {
+        cmd = data & 0x70;
+        bits = 0;
+        return 0;
+      }
+      bits++;
+      switch (cmd) {
+        case CMD_Z1_POS: return pressure;
+        case CMD_Z2_POS: return 127; //Z1 + 127 - Z2 = pressure
+        case CMD_X_POS:  v = 1023 - x; break;
+        case CMD_Y_POS:  v = y; break;
+        default:         return 0;
+      }
+      return (bits == 1) ? (v >> 2) : ((v & 3) << 6); //10 bit in the 12 bit frame
+    }
+
+  private:
+    const TOUCH *session;
+    uint8_t count;
+    uint8_t cmd, bits;
+    uint16_t x, y;
+    uint8_t pressure;
+
+    static const uint8_t CMD_START = 0x80;
+};
+
+//the calibration of TOUCH_RAW_X() and TOUCH_RAW_Y()
+static inline void touch_calibration(ADS7846 *tp) {
+	CAL_POINT lcd[3] = { CAL_POINT1, CAL_POINT2, CAL_POINT3 };
+	CAL_POINT raw[3] = { { 150, 167 }, { 850, 500 }, { 500, 833 } };
+
+	tp->setCalibration(lcd, raw);
+
+	return;
+}
+
+
+#endif //TouchMock_h
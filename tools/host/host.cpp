@@ -0,0 +1,42 @@
+//Host build (tools/host): Arduino core and I/O registers for the libraries compiled with SPI_MOCK
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+volatile uint8_t PORTB, PORTC, PORTD;
+volatile uint8_t DDRB, DDRC, DDRD;
+volatile uint8_t PINB, PINC, PIND;
+volatile uint8_t SPCR, SPSR, SPDR;
+volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UDR0;
+volatile uint16_t UBRR0;
+volatile uint8_t TCCR0A, TCCR1A, TCCR2A;
+
+uint8_t host_eeprom[E2END + 1];
+
+static unsigned long host_ms;
+
+//erased EEPROM
+static struct EepromErase
+{
+  EepromErase(void) { memset(host_eeprom, 0xFF, sizeof(host_eeprom)); }
+} eeprom_erase;
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t val) {}
+int digitalRead(uint8_t pin) { return LOW; }
+int analogRead(uint8_t pin) { return 0; }
+void analogWrite(uint8_t pin, int val) {}
+
+unsigned long millis(void) {
+	return host_ms++;
+}
+
+unsigned long micros(void) {
+	return host_ms * 1000UL;
+}
+
+void delay(unsigned long ms) {
+	host_ms += ms;
+}
+
+void delayMicroseconds(unsigned int us) {}
@@ -0,0 +1,246 @@
+//Touch replay test: golden/touch.rec is replayed through ADS7846::service(), the samples of getSample()
+//must form two touches (DOWN MOVE.. UP) and match golden/touch.txt.
+//The stream is also recorded again from a scripted touch controller and compared with golden/touch.rec.
+//
+//replay <golden dir>          exit code 1 if a sample or the recorded stream differs
+//replay <golden dir> update   records the session and rewrites touch.rec and touch.txt
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <SPIBus.h>
+#include <ADS7846.h>
+#include "TouchMock.h"
+
+#define STREAM_MAX  (2048)
+#define EVENTS_MAX  (256)
+#define SESSION_END (1000) //ms
+
+//scripted session: a stroke and a tap
+static const TOUCH session[] = {
+	{ 100, 400, 250, 300, 650, 600, 60 },
+	{ 600, 680, 500, 700, 500, 700, 80 }
+};
+
+#define TOUCHES (sizeof(session) / sizeof(session[0]))
+
+class BufferPrint : public Print
+{
+  public:
+    uint8_t data[STREAM_MAX];
+    uint16_t length;
+
+    BufferPrint(void) : length(0) {}
+    virtual size_t write(uint8_t c) {
+      if (length >= STREAM_MAX) {
+        return 0;
+      }
+      data[length++] = c;
+      return 1;
+    }
+};
+
+typedef struct
+{
+  uint8_t pen;
+  uint16_t x, y;
+  uint8_t pressure;
+} EVENT;
+
+static const char *pen_names[] = { "NONE", "DOWN", "MOVE", "UP" };
+
+static TouchMock panel(session, TOUCHES);
+static ADS7846 tp;
+static BufferPrint recording;
+static EVENT events[EVENTS_MAX];
+static uint16_t event_count;
+
+//-------------------- Helpers --------------------
+
+//samples with pen != NONE, repeated samples without change are skipped
+static void add_event(const TP_SAMPLE *s) {
+	EVENT *last = (event_count != 0) ? &events[event_count - 1] : 0;
+
+	if ((s->pen == TP_PEN_NONE) || (event_count >= EVENTS_MAX)) {
+		return;
+	}
+	if ((last != 0) && (s->pen == TP_PEN_MOVE) && (last->pen != TP_PEN_UP) && (last->x == s->x) && (last->y == s->y)) {
+		return;
+	}
+	events[event_count].pen = s->pen;
+	events[event_count].x = s->x;
+	events[event_count].y = s->y;
+	events[event_count].pressure = s->pressure;
+	event_count++;
+
+	return;
+}
+
+static uint8_t load_stream(const char *file, uint8_t *buf, uint16_t *length) {
+	FILE *f = fopen(file, "rb");
+
+	if (f == 0) {
+		return 1;
+	}
+	*length = fread(buf, 1, STREAM_MAX, f);
+	fclose(f);
+
+	return 0;
+}
+
+//DOWN MOVE.. UP for every touch of the session
+static uint8_t check_touches(void) {
+	uint8_t touches = 0, down = 0;
+	uint16_t i;
+
+	for (i = 0; i < event_count; i++) {
+		switch (events[i].pen) {
+			case TP_PEN_DOWN:
+				if (down) {
+					return 1;
+				}
+				down = 1;
+				touches++;
+				break;
+			case TP_PEN_MOVE:
+				if (!down) {
+					return 1;
+				}
+				break;
+			case TP_PEN_UP:
+				if (!down) {
+					return 1;
+				}
+				down = 0;
+				break;
+		}
+	}
+
+	return (down || (touches != TOUCHES)) ? 1 : 0;
+}
+
+static uint8_t compare_events(const char *file) {
+	char name[8];
+	unsigned int x, y, p;
+	uint16_t i = 0;
+	uint8_t failed = 0;
+	FILE *f = fopen(file, "r");
+
+	if (f == 0) {
+		printf("  no %s\n", file);
+		return 1;
+	}
+	while (fscanf(f, "%7s %u %u %u", name, &x, &y, &p) == 4) {
+		if (i >= event_count) {
+			printf("  missing: %s %u %u %u\n", name, x, y, p);
+			failed = 1;
+		} else if ((strcmp(name, pen_names[events[i].pen]) != 0) || (x != events[i].x) || (y != events[i].y)
+				|| (p != events[i].pressure)) {
+			printf("  sample %u: %s %u %u %u, expected %s %u %u %u\n", i, pen_names[events[i].pen], events[i].x, events[i].y,
+					events[i].pressure, name, x, y, p);
+			failed = 1;
+		}
+		i++;
+	}
+	fclose(f);
+	if (i < event_count) {
+		printf("  %u more samples than expected\n", event_count - i);
+		failed = 1;
+	}
+
+	return failed;
+}
+
+//-------------------- Main --------------------
+
+int main(int argc, char **argv) {
+	static uint8_t stream[STREAM_MAX];
+	char rec_file[256], txt_file[256];
+	uint16_t length, start, i;
+	uint8_t update, failed = 0;
+	FILE *f;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <golden dir> [update]\n", argv[0]);
+		return 2;
+	}
+	update = (argc > 2) && (strcmp(argv[2], "update") == 0);
+	snprintf(rec_file, sizeof(rec_file), "%s/touch.rec", argv[1]);
+	snprintf(txt_file, sizeof(txt_file), "%s/touch.txt", argv[1]);
+
+	SPIBus::mock = &panel;
+	tp.init();
+	touch_calibration(&tp);
+
+	//record the scripted session
+	panel.set(0);
+	tp.service();
+	start = millis();
+	tp.record(&recording);
+	for (;;) {
+		uint16_t ms = (uint16_t) millis() - start;
+
+		if (ms >= SESSION_END) {
+			break;
+		}
+		panel.set(ms);
+		tp.service();
+		add_event(tp.getSample());
+	}
+	tp.record(0);
+
+	if (update) {
+		f = fopen(rec_file, "wb");
+		if ((f == 0) || (fwrite(recording.data, 1, recording.length, f) != recording.length)) {
+			fprintf(stderr, "can't write %s\n", rec_file);
+			return 2;
+		}
+		fclose(f);
+		f = fopen(txt_file, "w");
+		if (f == 0) {
+			fprintf(stderr, "can't write %s\n", txt_file);
+			return 2;
+		}
+		for (i = 0; i < event_count; i++) {
+			fprintf(f, "%s %u %u %u\n", pen_names[events[i].pen], events[i].x, events[i].y, events[i].pressure);
+		}
+		fclose(f);
+		printf("touch        %5u bytes  %u samples  updated\n", recording.length, event_count);
+		return check_touches();
+	}
+
+	//replay the checked-in stream with another calibration, the stream restores its own
+	if (load_stream(rec_file, stream, &length) != 0) {
+		printf("touch        no %s\n", rec_file);
+		return 1;
+	}
+	printf("touch        %5u bytes  ", length);
+	if ((length != recording.length) || (memcmp(stream, recording.data, length) != 0)) {
+		printf("recording differs  ");
+		failed = 1;
+	}
+	tp.tp_matrix.div = 0;
+	event_count = 0;
+	tp.replay(stream, length, 0);
+	if (!tp.isReplaying()) {
+		printf("invalid stream\n");
+		return 1;
+	}
+	while (tp.isReplaying()) {
+		tp.service();
+		add_event(tp.getSample());
+	}
+	tp.service(); //released at the end of the stream
+	add_event(tp.getSample());
+	printf("%u samples", event_count);
+	if (check_touches() != 0) {
+		printf("  not %u touches (DOWN MOVE.. UP)", (unsigned int) TOUCHES);
+		failed = 1;
+	}
+	printf("%s\n", failed ? "" : "  ok");
+	if (compare_events(txt_file) != 0) {
+		failed = 1;
+	}
+
+	return failed;
+}
@@ -0,0 +1,57 @@
+#!/bin/sh
+# Builds the libraries for the host with SPI_MOCK and runs the golden image, touch replay and sketch tests.
+# The scenes and the sketch run again with LCD_PALETTE and must match the same golden files.
+#
+# run.sh          exit code 1 if a frame, a SPI byte count or a touch sample differs from tools/host/golden
+# run.sh update   rewrites the golden images, byte counts and the touch recordings (review them before committing)
+
+dir=$(cd "$(dirname "$0")" && pwd)
+lib="$dir/../../lib"
+src="$dir/../../src"
+out=$(mktemp -d) || exit 2
+CC=${CC:-gcc}
+CXX=${CXX:-g++}
+flags="-Wno-int-to-pointer-cast -DARDUINO=100 -DSPI_MOCK -DTP_RECORD -I$dir/stubs -I$lib/SPIBus -I$lib/MI0283QT2 -I$lib/ADS7846 \
+	-I$lib/TouchGui -I$lib/Chart"
+sketch_flags="-I$lib/i2cmaster -I$lib/Profiler -I$lib/MemoryMonitor -I$src"
+
+# build <dir> <flags>: the tests and the sketches with the color mode of the flags
+build() {
+	mkdir -p "$1" &&
+	$CC -std=gnu99 $flags $2 -c "$lib/MI0283QT2/font_8x12.c" -o "$1/font.o" &&
+	$CXX -std=gnu++98 $flags $2 -o "$1/scenes" "$dir/scenes.cpp" "$dir/host.cpp" "$lib/TouchGui/TouchButton.cpp" \
+		"$lib/TouchGui/TouchButtonAutorepeat.cpp" "$lib/TouchGui/TouchSlider.cpp" "$lib/Chart/Chart.cpp" \
+		"$lib/MI0283QT2/MI0283QT2.cpp" "$lib/SPIBus/SPIBus.cpp" "$lib/SPIBus/SPIMock.cpp" "$1/font.o" &&
+	$CXX -std=gnu++98 $flags $2 -o "$1/replay" "$dir/replay.cpp" "$dir/host.cpp" "$lib/ADS7846/ADS7846.cpp" \
+		"$lib/MI0283QT2/MI0283QT2.cpp" "$lib/SPIBus/SPIBus.cpp" "$lib/SPIBus/SPIMock.cpp" "$1/font.o" &&
+	$CXX -std=gnu++98 $flags $sketch_flags $2 -o "$1/sketch" "$dir/sketch.cpp" "$dir/host.cpp" -x c++ "$src/TouchGui.ino" \
+		-x none "$src/GameOfLife.cpp" "$lib/TouchGui/TouchButton.cpp" "$lib/TouchGui/TouchButtonAutorepeat.cpp" \
+		"$lib/TouchGui/TouchSlider.cpp" "$lib/TouchGui/TouchGesture.cpp" "$lib/TouchGui/TouchStroke.cpp" \
+		"$lib/Chart/Chart.cpp" "$lib/ADS7846/ADS7846.cpp" "$lib/MI0283QT2/MI0283QT2.cpp" "$lib/SPIBus/SPIBus.cpp" \
+		"$lib/SPIBus/SPIMock.cpp" "$1/font.o" &&
+	$CXX -std=gnu++98 $flags $sketch_flags $2 -c -x c++ "$src/TwoButtons.ino" -o "$1/TwoButtons.o"
+}
+
+build "$out/rgb565" "" && build "$out/palette" "-DLCD_PALETTE" || exit 2
+
+failed=0
+cd "$out/rgb565" || exit 2
+"$out/rgb565/scenes" "$dir/golden" $1 || failed=1
+"$out/rgb565/replay" "$dir/golden" $1 || failed=1
+if [ "$1" = "update" ]; then
+	"$out/rgb565/sketch" "$dir/golden" record || failed=1
+fi
+"$out/rgb565/sketch" "$dir/golden" $1 || failed=1
+
+# LCD_PALETTE: the same frames and byte counts with palette indices as color_t
+echo "LCD_PALETTE"
+cd "$out/palette" || exit 2
+"$out/palette/scenes" "$dir/golden" || failed=1
+"$out/palette/sketch" "$dir/golden" || failed=1
+
+if [ $failed -ne 0 ]; then
+	echo "failed, frames in $out" >&2
+else
+	rm -rf "$out"
+fi
+exit $failed
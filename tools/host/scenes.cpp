@@ -0,0 +1,326 @@
+//Golden image tests: every scene is drawn on a HX8347Mock and compared with golden/<scene>.ppm,
+//the SPI bytes of the scene with golden/bytes.txt.
+//
+//scenes <golden dir>          exit code 1 if a frame or a byte count differs, the frame is saved as <scene>.ppm
+//scenes <golden dir> update   rewrites the golden files
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <SPIBus.h>
+#include <MI0283QT2.h>
+#include <TouchButton.h>
+#include <TouchButtonAutorepeat.h>
+#include <TouchSlider.h>
+#include <Chart.h>
+
+#define SCENE_NAME_LEN (16)
+
+typedef struct
+{
+  const char *name;
+  void (*draw)(void);
+} SCENE;
+
+static HX8347Mock panel;
+MI0283QT2 TFTDisplay; //the widgets draw on the display of the main program (TOUCHGUI_SAVE_SPACE)
+static MI0283QT2 &lcd = TFTDisplay;
+
+//-------------------- Scenes --------------------
+
+//any RGB565 color, with LCD_PALETTE through the first entry after the default colors
+static color_t scene_color(uint16_t rgb565) {
+#if defined(LCD_PALETTE)
+	lcd.setPaletteColor(7, rgb565);
+	return 7;
+#else
+	return rgb565;
+#endif
+}
+
+static void scene_shapes(void) {
+	static const LCD_POINT star[] = { { 250, 130 }, { 262, 165 }, { 300, 165 }, { 270, 187 }, { 281, 225 }, { 250, 202 },
+			{ 219, 225 }, { 230, 187 } };
+	uint16_t i;
+
+	lcd.fillRect(5, 5, 50, 40, COLOR_RED);
+	lcd.drawRect(60, 5, 100, 40, COLOR_BLUE);
+	lcd.fillRect(50, 45, 5, 48, COLOR_GREEN); //x1 < x0
+	for (i = 0; i < 10; i++) {
+		lcd.drawLine(110, 5 + i * 4, 150 + i * 15, 40 - i * 4, scene_color(RGB(i * 25, 0, (255 - i * 25))));
+	}
+	lcd.drawLine(0, 0, 319, 239, COLOR_BLACK);
+	lcd.drawLine(300, 10, 250, 230, COLOR_RED);
+	lcd.drawCircle(160, 120, 40, COLOR_BLUE);
+	lcd.fillCircle(60, 120, 25, COLOR_GREEN);
+	lcd.drawCircle(5, 235, 20, COLOR_BLACK); //partly outside
+	lcd.fillCircle(315, 5, 20, COLOR_RED);
+	lcd.fillTriangle(20, 230, 70, 160, 120, 215, COLOR_YELLOW);
+	lcd.fillTriangle(130, 170, 130, 230, 131, 200, COLOR_BLACK); //sliver
+	lcd.fillPolygon(star, 8, COLOR_BLUE);
+	lcd.fillCapsule(150, 70, 280, 110, 6, COLOR_GRAY);
+	lcd.fillCapsule(200, 60, 200, 60, 4, COLOR_BLACK); //dot
+	lcd.fillCapsule(180, 200, 200, 235, 0, COLOR_RED); //line
+	lcd.drawPixel(319, 239, COLOR_RED);
+
+	return;
+}
+
+static void scene_text(void) {
+	lcd.drawText(5, 5, (char*) "Hello World", 1, COLOR_BLACK, COLOR_YELLOW);
+	lcd.drawText(5, 20, (char*) "Size 2", 2, COLOR_RED, COLOR_WHITE);
+	lcd.drawText(5, 48, (char*) "Transparent", 1, COLOR_BLUE, COLOR_TRANSPARENT);
+	lcd.drawText(110, 48, (char*) "Same colors", 1, COLOR_RED, COLOR_RED); //solid cells
+	lcd.drawTextPGM(200, 5, PSTR("PGM text over the edge"), 1, COLOR_BLUE, COLOR_WHITE);
+	lcd.drawMLText(5, 70, 150, 160,
+			(char*) "The quick brown fox jumps over the lazy dog. Supercalifragilisticexpialidocious!\nNew line.", 1,
+			COLOR_BLACK, COLOR_YELLOW);
+	lcd.drawMLTextPGM(160, 70, 310, 160, PSTR("Wrapped text from program memory, two sizes"), 2, COLOR_WHITE,
+			COLOR_BLUE);
+	lcd.drawInteger(5, 170, (int) -1234, DEC, 1, COLOR_BLACK, COLOR_WHITE);
+	lcd.drawInteger(80, 170, (long) 0xBEEF, HEX, 1, COLOR_BLACK, COLOR_WHITE);
+	lcd.drawInteger(160, 170, (unsigned int) 42, DEC, 6, '0', 1, COLOR_BLACK, COLOR_WHITE);
+	lcd.drawText(240, 170, (unsigned long) 4000000000UL, 1, COLOR_BLACK, COLOR_WHITE);
+	lcd.printOptions(1, COLOR_BLACK, COLOR_GRAY);
+	lcd.printXY(5, 190);
+	lcd.print("print() wraps a long line at the right edge of the screen\nsecond line");
+
+	return;
+}
+
+static void scene_clip(void) {
+	lcd.pushClip(40, 30, 279, 209);
+	lcd.fillRect(0, 0, 319, 239, COLOR_GRAY);
+	lcd.pushClip(100, 80, 219, 159);
+	lcd.fillCircle(100, 80, 50, COLOR_RED);
+	lcd.drawText(90, 150, (char*) "clipped text", 2, COLOR_BLACK, COLOR_YELLOW);
+	lcd.drawLine(0, 239, 319, 0, COLOR_BLUE);
+	lcd.popClip();
+	lcd.fillCapsule(20, 20, 300, 220, 8, COLOR_GREEN);
+	lcd.drawText(250, 200, (char*) "edge", 2, COLOR_WHITE, COLOR_BLACK);
+	lcd.popClip();
+	lcd.drawRect(39, 29, 280, 210, COLOR_BLACK);
+
+	return;
+}
+
+static const char *percent_value(uint8_t value) {
+	static char s[5];
+
+	s[0] = '0' + (value / 100);
+	s[1] = '0' + ((value / 10) % 10);
+	s[2] = '0' + (value % 10);
+	s[3] = '%';
+	s[4] = 0;
+
+	return s;
+}
+
+static void scene_buttons(void) {
+	static const char caption_PGM[] PROGMEM = "PGM";
+	static TouchButton simple, colored, pgm, textonly, untitled, recaptioned;
+	static TouchButtonAutorepeat autorepeat;
+
+	simple.initSimpleButton(5, 5, 90, 40, "Simple", 1, 0, 0);
+	colored.initButton(110, 5, 150, 50, "Size 2", 2, 4, COLOR_BLUE, COLOR_WHITE, 1, 0);
+	pgm.initSimpleButtonPGM(5, 60, 60, 30, caption_PGM, 2, 2, 0);
+	textonly.initButton(80, 70, 0, 0, "No box", 2, 0, COLOR_RED, COLOR_BLACK, 3, 0); //aWidthX = 0: caption only
+	untitled.initButton(5, 110, 60, 25, 0, 1, 0, COLOR_YELLOW, COLOR_BLACK, 4, 0);
+	recaptioned.initButton(80, 110, 120, 40, "Old", 2, 0, COLOR_GREEN, COLOR_BLACK, 5, 0);
+	autorepeat.initButton(5, 170, 180, 50, "Repeat", 2, 0, COLOR_GRAY, COLOR_RED, 6, 0);
+	simple.drawButton();
+	colored.drawButton();
+	pgm.drawButton();
+	textonly.drawButton();
+	untitled.drawButton();
+	recaptioned.drawButton();
+	recaptioned.setCaption("New");
+	recaptioned.setCaptionColor(COLOR_RED);
+	recaptioned.drawCaption();
+	autorepeat.drawButton();
+	autorepeat.setColor(COLOR_BLUE);
+	autorepeat.setCaptionColor(COLOR_WHITE);
+	autorepeat.drawButton();
+
+	return;
+}
+
+static void scene_sliders(void) {
+	static TouchSlider simple, borderless, valued, threshold, handled, colored;
+
+	simple.initSimpleSlider(5, 5, 4, "Simple", true, 0, 0);
+	borderless.initSlider(70, 5, 6, 100, false, "Bar", 30, 80, true, 4, 0, 0);
+	valued.initSlider(120, 5, 3, 120, true, 0, 60, 120, true, 4, 0, 0);
+	threshold.initSlider(170, 5, 4, 150, true, "Thr", 140, 100, false, 4, 0, 0);
+	handled.initSlider(230, 5, 4, 100, true, "%", 42, 100, true, 4, 0, percent_value);
+	colored.initSlider(280, 5, 3, 200, true, 0, 150, 100, false, 4, 0, 0);
+	colored.initSliderColors(COLOR_BLUE, COLOR_YELLOW, COLOR_RED, COLOR_GRAY, COLOR_BLACK, COLOR_BLACK, COLOR_WHITE);
+	simple.drawSlider();
+	borderless.drawSlider();
+	valued.drawSlider();
+	threshold.drawSlider();
+	handled.drawSlider();
+	colored.drawSlider();
+	valued.setActualValue(90);
+	valued.drawBar();
+
+	return;
+}
+
+static void scene_chart(void) {
+	static Chart pixels, lines, area;
+	uint8_t data[120];
+	uint8_t i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (i < 60) ? (10 + i) : (130 - i); //triangle
+		data[i] += (i * 7) & 15; //noise
+	}
+
+	pixels.initChart(30, 100, 120, 90, 2, true, 20, 20);
+	pixels.initXLabelInt(0, 20, 2);
+	pixels.initYLabelInt(0, 20, 2);
+	pixels.drawAxes(false);
+	pixels.drawGrid();
+	pixels.drawChartData(data, sizeof(data), COLOR_RED, CHART_MODE_PIXEL);
+
+	lines.initChart(190, 100, 120, 90, 1, false, 40, 15);
+	lines.initChartColors(COLOR_BLUE, COLOR_GRAY, COLOR_BLUE, COLOR_WHITE);
+	lines.initXLabelFloat(-1.0, 0.5, 4, 1);
+	lines.initYLabelFloat(0, 2.5, 4, 1);
+	lines.drawAxes(false);
+	lines.drawChartData(data, sizeof(data), COLOR_BLUE, CHART_MODE_LINE);
+
+	area.initChart(30, 215, 280, 80, 2, true, 40, 20);
+	area.initChartColors(COLOR_BLACK, COLOR_GRAY, COLOR_BLACK, COLOR_YELLOW);
+	area.clear();
+	area.drawGrid();
+	area.drawAxes(false);
+	area.drawChartData(data, sizeof(data), COLOR_GREEN, CHART_MODE_AREA);
+
+	return;
+}
+
+static void scene_orientation(void) {
+	uint16_t o;
+
+	for (o = 0; o < 360; o += 90) {
+		lcd.setOrientation(o);
+		lcd.fillRect(0, 0, 30, 10, COLOR_RED); //marks the origin
+		lcd.drawInteger(35, 0, (int) o, DEC, 1, COLOR_BLACK, COLOR_WHITE);
+		lcd.drawLine(0, 12, 60, 40, COLOR_BLUE);
+	}
+
+	return;
+}
+
+static const SCENE scenes[] = {
+	{ "shapes", scene_shapes },
+	{ "text", scene_text },
+	{ "clip", scene_clip },
+	{ "buttons", scene_buttons },
+	{ "sliders", scene_sliders },
+	{ "chart", scene_chart },
+	{ "orientation", scene_orientation }
+};
+
+#define SCENES (sizeof(scenes) / sizeof(scenes[0]))
+
+//-------------------- Main --------------------
+
+//expected SPI bytes of the scene, 0 if unknown
+static uint32_t expected_bytes(const char *dir, const char *name) {
+	char path[256], n[SCENE_NAME_LEN];
+	unsigned long bytes;
+	uint32_t result = 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%s/bytes.txt", dir);
+	f = fopen(path, "r");
+	if (f == 0) {
+		return 0;
+	}
+	while (fscanf(f, "%15s %lu", n, &bytes) == 2) {
+		if (strcmp(n, name) == 0) {
+			result = bytes;
+		}
+	}
+	fclose(f);
+
+	return result;
+}
+
+int main(int argc, char **argv) {
+	char path[256];
+	uint8_t update, failed = 0, i;
+	uint32_t bytes, expected;
+	int32_t diff;
+	FILE *list = 0;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <golden dir> [update]\n", argv[0]);
+		return 2;
+	}
+	update = (argc > 2) && (strcmp(argv[2], "update") == 0);
+	if (update) {
+		snprintf(path, sizeof(path), "%s/bytes.txt", argv[1]);
+		list = fopen(path, "w");
+		if (list == 0) {
+			fprintf(stderr, "can't write %s\n", path);
+			return 2;
+		}
+	}
+
+	SPIBus::mock = &panel;
+	lcd.init(4);
+
+	for (i = 0; i < SCENES; i++) {
+		lcd.setOrientation(0);
+		lcd.resetClip();
+		lcd.clear(COLOR_WHITE);
+		panel.clearCounters();
+		scenes[i].draw();
+		bytes = panel.bytes;
+
+		if (update) {
+			snprintf(path, sizeof(path), "%s/%s.ppm", argv[1], scenes[i].name);
+			if (panel.savePPM(path) != 0) {
+				fprintf(stderr, "can't write %s\n", path);
+				return 2;
+			}
+			fprintf(list, "%s %lu\n", scenes[i].name, (unsigned long) bytes);
+			printf("%-12s %8lu bytes  updated\n", scenes[i].name, (unsigned long) bytes);
+			continue;
+		}
+
+		snprintf(path, sizeof(path), "%s/%s.ppm", argv[1], scenes[i].name);
+		diff = panel.comparePPM(path);
+		expected = expected_bytes(argv[1], scenes[i].name);
+		printf("%-12s %8lu bytes", scenes[i].name, (unsigned long) bytes);
+		if (diff != 0) {
+			if (diff < 0) {
+				printf("  no golden image");
+			} else {
+				printf("  %ld pixels differ", (long) diff);
+			}
+			snprintf(path, sizeof(path), "%s.ppm", scenes[i].name);
+			panel.savePPM(path);
+			failed = 1;
+		}
+		if (bytes != expected) {
+			printf("  expected %lu bytes", (unsigned long) expected);
+			failed = 1;
+		}
+		if (panel.errors != 0) {
+			printf("  %u pixels outside of the panel", panel.errors);
+			failed = 1;
+		}
+		printf("%s\n", ((diff == 0) && (bytes == expected) && (panel.errors == 0)) ? "  ok" : "");
+	}
+
+	if (list != 0) {
+		fclose(list);
+	}
+
+	return failed;
+}
@@ -0,0 +1,341 @@
+//Sketch test: src/TouchGui.ino runs setup() and loop() on the host, golden/session.rec is replayed through
+//TouchPanel.replay() until the end of the stream. The SPI bytes of the LCD and the touch controller are counted
+//for setup() and for the session and compared with golden/sketch.txt, the last frame with golden/sketch.ppm.
+//
+//sketch <golden dir>          exit code 1 if the frame or a count differs, the frame is saved as sketch.ppm
+//sketch <golden dir> record   records the scripted session from the touch controller model to session.rec
+//sketch <golden dir> update   replays session.rec and rewrites sketch.ppm and sketch.txt
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <SPIBus.h>
+#include <MI0283QT2.h>
+#include <ADS7846.h>
+#include "TouchMock.h"
+
+extern "C" {
+#include <i2cmaster.h>
+}
+
+#define STREAM_MAX  (4096)
+#define SESSION_END (1800) //ms
+#define LOOPS_AFTER (300) //loops after the end of the stream, the sketch finishes the stroke
+#define STATS_NAME_LEN (16)
+
+//estimated bus time in us, 16MHz: LCD at Fcpu/4 (initStart(4)), touch controller at Fcpu/8
+#define LCD_BYTE_US (2)
+#define TP_BYTE_US  (4)
+
+extern ADS7846 TouchPanel;
+extern MI0283QT2 TFTDisplay;
+void setup(void);
+void loop(void);
+
+//scripted session in screen positions: "Draw" button, a stroke, the red color button, a stroke
+static const TOUCH session[] = {
+	{ 100, 200, TOUCH_RAW_X(80), TOUCH_RAW_Y(35), TOUCH_RAW_X(80), TOUCH_RAW_Y(35), 80 },
+	{ 400, 800, TOUCH_RAW_X(60), TOUCH_RAW_Y(80), TOUCH_RAW_X(250), TOUCH_RAW_Y(200), 60 },
+	{ 1000, 1100, TOUCH_RAW_X(15), TOUCH_RAW_Y(45), TOUCH_RAW_X(15), TOUCH_RAW_Y(45), 80 },
+	{ 1200, 1600, TOUCH_RAW_X(80), TOUCH_RAW_Y(200), TOUCH_RAW_X(280), TOUCH_RAW_Y(60), 60 }
+};
+
+#define TOUCHES (sizeof(session) / sizeof(session[0]))
+
+//LCD and touch controller on one bus, the bytes are counted per device
+class BoardMock : public SPIMock
+{
+  public:
+    HX8347Mock lcd;
+    TouchMock tp;
+    uint32_t lcd_bytes, tp_bytes;
+
+    BoardMock(const TOUCH *session, uint8_t count) : tp(session, count), lcd_bytes(0), tp_bytes(0) {}
+
+    virtual void begin(uint8_t dev) {
+      SPIMock::begin(dev);
+      lcd.begin(dev);
+      tp.begin(dev);
+    }
+
+    virtual void end(void) {
+      SPIMock::end();
+      lcd.end();
+      tp.end();
+    }
+
+    virtual uint8_t transfer(uint8_t data) {
+      bytes++;
+      if (device == SPI_DEVICE_LCD) {
+        lcd_bytes++;
+        return lcd.transfer(data);
+      }
+      tp_bytes++;
+      return tp.transfer(data);
+    }
+};
+
+class BufferPrint : public Print
+{
+  public:
+    uint8_t data[STREAM_MAX];
+    uint16_t length;
+
+    BufferPrint(void) : length(0) {}
+    virtual size_t write(uint8_t c) {
+      if (length >= STREAM_MAX) {
+        return 0;
+      }
+      data[length++] = c;
+      return 1;
+    }
+};
+
+typedef struct
+{
+  const char *name;
+  uint32_t loops;
+  uint32_t lcd_bytes, tp_bytes;
+  uint32_t max_bytes; //slowest loop
+} STATS;
+
+static BoardMock board(session, TOUCHES);
+static BufferPrint recording;
+
+//-------------------- DS1307 --------------------
+
+//fixed time: 08:30:00 24.12.2011, BCD
+static const uint8_t rtc_time[7] = { 0x00, 0x30, 0x08, 0x06, 0x24, 0x12, 0x11 };
+static uint8_t rtc_pos;
+
+extern "C" {
+
+void i2c_init(void) {}
+void i2c_stop(void) {}
+
+unsigned char i2c_start(unsigned char addr) {
+	return 0;
+}
+
+unsigned char i2c_write(unsigned char data) {
+	rtc_pos = data; //register address, the sketch writes no time
+	return 0;
+}
+
+unsigned char i2c_readAck(void) {
+	return rtc_time[rtc_pos++ % sizeof(rtc_time)];
+}
+
+unsigned char i2c_readNak(void) {
+	return rtc_time[rtc_pos++ % sizeof(rtc_time)];
+}
+
+}
+
+//-------------------- Helpers --------------------
+
+//calibration of the touch controller model in the EEPROM of the sketch (TP_EEPROMADDR)
+static void write_calibration(void) {
+	ADS7846 tp;
+
+	touch_calibration(&tp);
+	tp.writeCalibration(E2END - 1 - sizeof(CAL_MATRIX));
+
+	return;
+}
+
+static void run_loop(STATS *s) {
+	uint32_t lcd = board.lcd_bytes, tp = board.tp_bytes;
+
+	loop();
+	s->loops++;
+	if ((board.lcd_bytes - lcd + board.tp_bytes - tp) > s->max_bytes) {
+		s->max_bytes = board.lcd_bytes - lcd + board.tp_bytes - tp;
+	}
+
+	return;
+}
+
+static void begin_stats(STATS *s, const char *name) {
+	memset(s, 0, sizeof(STATS));
+	s->name = name;
+	board.lcd_bytes = 0;
+	board.tp_bytes = 0;
+
+	return;
+}
+
+static void end_stats(STATS *s) {
+	s->lcd_bytes = board.lcd_bytes;
+	s->tp_bytes = board.tp_bytes;
+
+	return;
+}
+
+static void print_stats(const STATS *s) {
+	printf("%-12s %5lu loops  %8lu LCD bytes  %5lu TP bytes  bus %5lu ms  slowest loop %5lu bytes", s->name,
+			(unsigned long) s->loops, (unsigned long) s->lcd_bytes, (unsigned long) s->tp_bytes,
+			(unsigned long) ((s->lcd_bytes * LCD_BYTE_US + s->tp_bytes * TP_BYTE_US) / 1000),
+			(unsigned long) s->max_bytes);
+
+	return;
+}
+
+//0 if the counts of golden/sketch.txt match
+static uint8_t compare_stats(const char *file, const STATS *s) {
+	char n[STATS_NAME_LEN];
+	unsigned long loops, lcd, tp, max;
+	uint8_t failed = 1;
+	FILE *f = fopen(file, "r");
+
+	if (f == 0) {
+		printf("  no %s", file);
+		return 1;
+	}
+	while (fscanf(f, "%15s %lu %lu %lu %lu", n, &loops, &lcd, &tp, &max) == 5) {
+		if (strcmp(n, s->name) == 0) {
+			failed = (loops != s->loops) || (lcd != s->lcd_bytes) || (tp != s->tp_bytes) || (max != s->max_bytes);
+			if (failed) {
+				printf("  expected %lu %lu %lu %lu", loops, lcd, tp, max);
+			}
+		}
+	}
+	fclose(f);
+
+	return failed;
+}
+
+static uint8_t load_stream(const char *file, uint8_t *buf, uint16_t *length) {
+	FILE *f = fopen(file, "rb");
+
+	if (f == 0) {
+		return 1;
+	}
+	*length = fread(buf, 1, STREAM_MAX, f);
+	fclose(f);
+
+	return 0;
+}
+
+//-------------------- Main --------------------
+
+int main(int argc, char **argv) {
+	static uint8_t stream[STREAM_MAX];
+	char rec_file[256], txt_file[256], ppm_file[256];
+	uint16_t length, start, i;
+	uint8_t record, update, failed = 0;
+	int32_t diff;
+	STATS stats[2];
+	FILE *f;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s <golden dir> [record|update]\n", argv[0]);
+		return 2;
+	}
+	record = (argc > 2) && (strcmp(argv[2], "record") == 0);
+	update = (argc > 2) && (strcmp(argv[2], "update") == 0);
+	snprintf(rec_file, sizeof(rec_file), "%s/session.rec", argv[1]);
+	snprintf(txt_file, sizeof(txt_file), "%s/sketch.txt", argv[1]);
+	snprintf(ppm_file, sizeof(ppm_file), "%s/sketch.ppm", argv[1]);
+
+	SPIBus::mock = &board;
+	write_calibration();
+
+	begin_stats(&stats[0], "setup");
+	setup();
+	end_stats(&stats[0]);
+
+	if (record) {
+		//the scripted touches, no checks
+		begin_stats(&stats[1], "record");
+		board.tp.set(0);
+		start = millis();
+		TouchPanel.record(&recording);
+		for (;;) {
+			uint16_t ms = (uint16_t) millis() - start;
+
+			if (ms >= SESSION_END) {
+				break;
+			}
+			board.tp.set(ms);
+			run_loop(&stats[1]);
+		}
+		TouchPanel.record(0);
+		end_stats(&stats[1]);
+		f = fopen(rec_file, "wb");
+		if ((f == 0) || (fwrite(recording.data, 1, recording.length, f) != recording.length)) {
+			fprintf(stderr, "can't write %s\n", rec_file);
+			return 2;
+		}
+		fclose(f);
+		print_stats(&stats[1]);
+		printf("  %u bytes recorded\n", recording.length);
+		return (recording.length < STREAM_MAX) ? 0 : 1;
+	}
+
+	//replay the checked-in session, the touch controller model is not touched
+	if (load_stream(rec_file, stream, &length) != 0) {
+		printf("sketch       no %s\n", rec_file);
+		return 1;
+	}
+	begin_stats(&stats[1], "session");
+	TouchPanel.replay(stream, length, 0);
+	if (!TouchPanel.isReplaying()) {
+		printf("sketch       invalid stream\n");
+		return 1;
+	}
+	while (TouchPanel.isReplaying()) {
+		run_loop(&stats[1]);
+	}
+	for (i = 0; i < LOOPS_AFTER; i++) {
+		run_loop(&stats[1]);
+	}
+	end_stats(&stats[1]);
+
+	if (update) {
+		if (board.lcd.savePPM(ppm_file) != 0) {
+			fprintf(stderr, "can't write %s\n", ppm_file);
+			return 2;
+		}
+		f = fopen(txt_file, "w");
+		if (f == 0) {
+			fprintf(stderr, "can't write %s\n", txt_file);
+			return 2;
+		}
+		for (i = 0; i < 2; i++) {
+			fprintf(f, "%s %lu %lu %lu %lu\n", stats[i].name, (unsigned long) stats[i].loops,
+					(unsigned long) stats[i].lcd_bytes, (unsigned long) stats[i].tp_bytes, (unsigned long) stats[i].max_bytes);
+			print_stats(&stats[i]);
+			printf("  updated\n");
+		}
+		fclose(f);
+		return 0;
+	}
+
+	for (i = 0; i < 2; i++) {
+		print_stats(&stats[i]);
+		if (compare_stats(txt_file, &stats[i]) != 0) {
+			failed = 1;
+		}
+		if (i == 1) {
+			diff = board.lcd.comparePPM(ppm_file);
+			if (diff < 0) {
+				printf("  no golden image");
+			} else if (diff > 0) {
+				printf("  %ld pixels differ", (long) diff);
+			}
+			if (diff != 0) {
+				board.lcd.savePPM("sketch.ppm");
+				failed = 1;
+			}
+		}
+		if (board.lcd.errors != 0) {
+			printf("  %u pixels outside of the panel", board.lcd.errors);
+			failed = 1;
+		}
+		printf("%s\n", failed ? "" : "  ok");
+	}
+
+	return failed;
+}
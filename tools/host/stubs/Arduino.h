@@ -0,0 +1,45 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+
+//Host build (tools/host): the Arduino core functions used by the libraries, implemented in host.cpp
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "Print.h"
+#include "WString.h"
+
+#define HIGH   (1)
+#define LOW    (0)
+#define INPUT  (0)
+#define OUTPUT (1)
+
+#define SDA    (18) //Uno
+#define SCL    (19)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <avr/io.h>
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+unsigned long millis(void); //every call is 1ms later, busy waits on millis() end
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+#ifdef __cplusplus
+}
+#endif
+
+#define noInterrupts()
+#define interrupts()
+
+
+#endif //Arduino_h
@@ -0,0 +1,68 @@
+#ifndef Print_h
+#define Print_h
+
+
+//Host build (tools/host): the Print interface of the Arduino core
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC (10)
+#define HEX (16)
+#define OCT (8)
+#define BIN (2)
+
+class Print
+{
+  public:
+    virtual ~Print(void) {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const char *s) { return write((const uint8_t*) s, strlen(s)); }
+    virtual size_t write(const uint8_t *s, size_t size)
+    {
+      size_t n;
+      for (n = 0; n < size; n++)
+      {
+        write(s[n]);
+      }
+      return n;
+    }
+    size_t print(const char *s) { return write(s); }
+    size_t print(char c) { return write((uint8_t) c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long) n, base); }
+    size_t print(int n, int base = DEC) { return print((long) n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long) n, base); }
+    size_t print(long n, int base = DEC)
+    {
+      if ((n < 0) && (base == DEC))
+      {
+        return print('-') + print(0UL - (unsigned long) n, base);
+      }
+      return print((unsigned long) n, base);
+    }
+    size_t print(unsigned long n, int base = DEC)
+    {
+      char buf[8 * sizeof(long) + 1];
+      char *s = &buf[sizeof(buf) - 1];
+
+      *s = 0;
+      do
+      {
+        *--s = "0123456789ABCDEF"[n % base];
+        n /= base;
+      } while (n != 0);
+      return write(s);
+    }
+    size_t println(void) { return write("\r\n"); }
+    size_t println(const char *s) { return print(s) + println(); }
+    size_t println(char c) { return print(c) + println(); }
+    size_t println(int n, int base = DEC) { return print(n, base) + println(); }
+    size_t println(unsigned int n, int base = DEC) { return print(n, base) + println(); }
+    size_t println(long n, int base = DEC) { return print(n, base) + println(); }
+    size_t println(unsigned long n, int base = DEC) { return print(n, base) + println(); }
+};
+
+
+#endif //Print_h
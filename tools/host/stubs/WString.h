@@ -0,0 +1,22 @@
+#ifndef WString_h
+#define WString_h
+
+
+//Host build (tools/host): read-only String, enough for the String overloads of the libraries
+
+#include <string.h>
+
+class String
+{
+  public:
+    String(const char *s = "") : str(s) {}
+    unsigned int length(void) const { return strlen(str); }
+    char operator[](unsigned int i) const { return str[i]; }
+    const char *c_str(void) const { return str; }
+
+  private:
+    const char *str;
+};
+
+
+#endif //WString_h
@@ -0,0 +1,20 @@
+#ifndef avr_eeprom_h
+#define avr_eeprom_h
+
+
+//Host build (tools/host): the EEPROM is host_eeprom[] (host.cpp), erased (0xFF) at start, addresses are offsets
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <avr/io.h>
+
+extern uint8_t host_eeprom[E2END + 1];
+
+static inline uint8_t eeprom_read_byte(const uint8_t *addr) { return host_eeprom[(size_t) addr & E2END]; }
+static inline void eeprom_write_byte(uint8_t *addr, uint8_t val) { host_eeprom[(size_t) addr & E2END] = val; }
+static inline void eeprom_read_block(void *dst, const void *src, size_t n) { memcpy(dst, &host_eeprom[(size_t) src & E2END], n); }
+static inline void eeprom_write_block(const void *src, void *dst, size_t n) { memcpy(&host_eeprom[(size_t) dst & E2END], src, n); }
+
+
+#endif //avr_eeprom_h
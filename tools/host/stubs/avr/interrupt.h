@@ -0,0 +1,11 @@
+#ifndef avr_interrupt_h
+#define avr_interrupt_h
+
+
+//Host build (tools/host): no interrupts
+
+#define cli()
+#define sei()
+
+
+#endif //avr_interrupt_h
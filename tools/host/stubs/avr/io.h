@@ -0,0 +1,44 @@
+#ifndef avr_io_h
+#define avr_io_h
+
+
+//Host build (tools/host): the I/O registers are plain variables (host.cpp).
+//With SPI_MOCK the libraries only set pins and SPI settings, nothing is read back.
+
+#include <stdint.h>
+
+extern volatile uint8_t PORTB, PORTC, PORTD;
+extern volatile uint8_t DDRB, DDRC, DDRD;
+extern volatile uint8_t PINB, PINC, PIND;
+extern volatile uint8_t SPCR, SPSR, SPDR;
+extern volatile uint8_t UCSR0A, UCSR0B, UCSR0C, UDR0;
+extern volatile uint16_t UBRR0;
+extern volatile uint8_t TCCR0A, TCCR1A, TCCR2A;
+
+#define SPR0    (0)
+#define SPR1    (1)
+#define CPHA    (2)
+#define CPOL    (3)
+#define MSTR    (4)
+#define DORD    (5)
+#define SPE     (6)
+#define SPI2X   (0)
+#define SPIF    (7)
+
+#define TXEN0   (3)
+#define UDRE0   (5)
+#define TXC0    (6)
+#define UMSEL00 (6)
+#define UMSEL01 (7)
+
+#define E2END   (1023) //ATmega328P
+
+#define COM0A1  (7)
+#define COM0B1  (5)
+#define COM1A1  (7)
+#define COM1B1  (5)
+#define COM2A1  (7)
+#define COM2B1  (5)
+
+
+#endif //avr_io_h
@@ -0,0 +1,23 @@
+#ifndef avr_pgmspace_h
+#define avr_pgmspace_h
+
+
+//Host build (tools/host): program memory is normal memory
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P                  const char *
+#define PSTR(s)                (s)
+typedef uint8_t prog_uint8_t;
+typedef uint16_t prog_uint16_t;
+typedef char prog_char;
+
+#define pgm_read_byte(addr)    (*(const uint8_t *) (addr))
+#define pgm_read_word(addr)    (*(const uint16_t *) (addr))
+#define pgm_read_dword(addr)   (*(const uint32_t *) (addr))
+#define strlen_P(s)            strlen(s)
+
+
+#endif //avr_pgmspace_h
@@ -0,0 +1,11 @@
+#ifndef util_delay_h
+#define util_delay_h
+
+
+//Host build (tools/host): no busy waiting
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+
+#endif //util_delay_h